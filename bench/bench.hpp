@@ -0,0 +1,198 @@
+#pragma once
+
+// Minimal benchmark harness. Each suite registers itself with
+// SHM_BENCH_SUITE and reports results through context::report, which
+// prints a table row and appends one JSON object per line to the output
+// file (bench_output.txt in the source tree by default).
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace shm::bench {
+
+struct options {
+    bool quick = false;
+    std::string filter;
+    std::string out_path;
+    std::size_t max_bytes = 0;  // 0: no cap on the working-set sweep
+};
+
+struct cache_sizes {
+    std::size_t l1;
+    std::size_t l2;
+    std::size_t llc;
+};
+
+cache_sizes detect_cache_sizes();
+
+struct result {
+    std::string suite;
+    std::string map;
+    std::string key;
+    std::string op;
+    std::size_t size;
+    std::size_t ops;
+    double ns_per_op;
+};
+
+class context {
+public:
+    context(options opts, std::FILE* out);
+
+    const options& opts() const noexcept { return opts_; }
+    const cache_sizes& caches() const noexcept { return caches_; }
+
+    // Element counts whose working set spans L1-resident up to 10x LLC
+    // (capped by --max-bytes, and by L2 with --quick).
+    std::vector<std::size_t> sizes(std::size_t bytes_per_element) const;
+
+    // Repetitions so that a case runs at least min_ops operations in total.
+    std::size_t reps(std::size_t ops_per_rep) const;
+
+    bool enabled(const std::string& name) const;
+
+    void report(const result& r);
+
+private:
+    options opts_;
+    cache_sizes caches_;
+    std::FILE* out_;
+};
+
+using suite_fn = void (*)(context&);
+
+struct registrar {
+    registrar(const char* name, suite_fn fn);
+};
+
+struct suite {
+    const char* name;
+    suite_fn fn;
+};
+
+std::vector<suite>& suites();
+
+#define SHM_BENCH_CONCAT_(a, b) a##b
+#define SHM_BENCH_CONCAT(a, b) SHM_BENCH_CONCAT_(a, b)
+#define SHM_BENCH_SUITE(name, fn) static ::shm::bench::registrar SHM_BENCH_CONCAT(shm_bench_reg_, __LINE__)(name, fn)
+
+// Keeps the optimiser from discarding a computed value.
+template <class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class timer {
+public:
+    timer() : start_(std::chrono::steady_clock::now()) {}
+    double elapsed_ns() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Runs body reps times and returns the best ns per operation.
+template <class Setup, class Body>
+double measure(std::size_t reps, std::size_t ops, Setup&& setup, Body&& body) {
+    double best = 1e300;
+    for (std::size_t r = 0; r != reps; ++r) {
+        setup();
+        timer t;
+        body();
+        best = std::min(best, t.elapsed_ns() / static_cast<double>(ops ? ops : 1));
+    }
+    return best;
+}
+
+// Key types exercised by the suites.
+struct key64 {
+    std::uint64_t words[8];
+    friend bool operator==(const key64& a, const key64& b) noexcept {
+        return std::memcmp(a.words, b.words, sizeof(a.words)) == 0;
+    }
+};
+
+struct key64_hash {
+    std::size_t operator()(const key64& k) const noexcept {
+        std::uint64_t h = 0;
+        for (std::uint64_t w : k.words) h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+};
+
+struct short_string {};
+struct long_string {};
+struct struct64 {};
+
+template <class Tag>
+struct key_kind;
+
+template <>
+struct key_kind<std::uint64_t> {
+    using type = std::uint64_t;
+    using hash = std::hash<std::uint64_t>;
+    static constexpr const char* name = "int64";
+    static constexpr std::uint64_t domain = ~std::uint64_t{};
+    static type make(std::uint64_t x) { return x; }
+};
+
+template <>
+struct key_kind<short_string> {
+    using type = std::string;
+    using hash = std::hash<std::string>;
+    static constexpr const char* name = "string_short";
+    static constexpr std::uint64_t domain = 100000000000000ULL;  // at most 14 digits: fits SSO
+    static type make(std::uint64_t x) { return std::to_string(x); }
+};
+
+template <>
+struct key_kind<long_string> {
+    using type = std::string;
+    using hash = std::hash<std::string>;
+    static constexpr const char* name = "string_long";
+    static constexpr std::uint64_t domain = ~std::uint64_t{};
+    static type make(std::uint64_t x) { return "/api/v2/objects/by-id/" + std::to_string(x) + "/attributes/primary"; }
+};
+
+template <>
+struct key_kind<struct64> {
+    using type = key64;
+    using hash = key64_hash;
+    static constexpr const char* name = "struct64";
+    static constexpr std::uint64_t domain = ~std::uint64_t{};
+    static type make(std::uint64_t x) {
+        key64 k;
+        for (std::uint64_t& w : k.words) w = x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        return k;
+    }
+};
+
+// Distinct keys: the first n are inserted, the next n are guaranteed misses.
+template <class Kind>
+std::vector<typename Kind::type> make_keys(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint64_t> raw;
+    raw.reserve(2 * n);
+    while (raw.size() < 2 * n) {
+        while (raw.size() < 2 * n) raw.push_back(Kind::domain == ~std::uint64_t{} ? rng() : rng() % Kind::domain);
+        std::sort(raw.begin(), raw.end());
+        raw.erase(std::unique(raw.begin(), raw.end()), raw.end());
+    }
+    std::shuffle(raw.begin(), raw.end(), rng);
+    std::vector<typename Kind::type> keys;
+    keys.reserve(raw.size());
+    for (auto x : raw) keys.push_back(Kind::make(x));
+    return keys;
+}
+
+}  // namespace shm::bench
@@ -0,0 +1,74 @@
+// Lifetime cost of short-lived maps: build a small table, look every key up
+// once and destroy it, with the default allocator, a pmr monotonic buffer
+// and shm::arena.
+
+#include <memory_resource>
+
+#include "bench.hpp"
+#include "shm/arena.hpp"
+#include "shm/super_hashmap.hpp"
+
+namespace shm::bench {
+namespace {
+
+using pair_type = std::pair<const std::uint64_t, std::uint64_t>;
+using hash_type = std::hash<std::uint64_t>;
+using eq_type = std::equal_to<std::uint64_t>;
+
+template <class Map, class MakeMap>
+double run(context& ctx, const std::vector<std::uint64_t>& keys, std::size_t n, MakeMap&& make_map) {
+    const std::size_t maps = std::max<std::size_t>(1, (1 << 20) / n);
+    return measure(ctx.reps(maps * n), maps * n, [] {}, [&] {
+        for (std::size_t m = 0; m != maps; ++m) {
+            make_map([&](Map& map) {
+                for (std::size_t i = 0; i != n; ++i) map.emplace(keys[i], i);
+                std::uint64_t sum = 0;
+                for (std::size_t i = 0; i != n; ++i) sum += map.find(keys[i])->second;
+                do_not_optimize(sum);
+            });
+        }
+    });
+}
+
+void arena_suite(context& ctx) {
+    for (std::size_t n : {16, 256, 4096}) {
+        const auto keys = make_keys<key_kind<std::uint64_t>>(n, n);
+        const auto emit = [&](const char* map_name, double ns) {
+            ctx.report({"arena", map_name, "int64", "short_lived", n, n, ns});
+        };
+
+        if (ctx.enabled("arena/std::allocator/int64/short_lived")) {
+            using map_type = super_hashmap<std::uint64_t, std::uint64_t>;
+            emit("std::allocator", run<map_type>(ctx, keys, n, [](auto&& body) {
+                     map_type map;
+                     body(map);
+                 }));
+        }
+
+        if (ctx.enabled("arena/pmr::monotonic/int64/short_lived")) {
+            using map_type = pmr::super_hashmap<std::uint64_t, std::uint64_t>;
+            emit("pmr::monotonic", run<map_type>(ctx, keys, n, [](auto&& body) {
+                     std::pmr::monotonic_buffer_resource resource;
+                     map_type map(&resource);
+                     body(map);
+                 }));
+        }
+
+        if (ctx.enabled("arena/shm::arena/int64/short_lived")) {
+            using map_type = super_hashmap<std::uint64_t, std::uint64_t, hash_type, eq_type, arena_allocator<pair_type>>;
+            arena scratch;
+            emit("shm::arena", run<map_type>(ctx, keys, n, [&](auto&& body) {
+                     {
+                         map_type map(scratch);
+                         body(map);
+                     }
+                     scratch.reset();
+                 }));
+        }
+    }
+}
+
+SHM_BENCH_SUITE("arena", arena_suite);
+
+}  // namespace
+}  // namespace shm::bench
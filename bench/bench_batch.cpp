@@ -0,0 +1,82 @@
+// Batched lookup against a loop of single finds, in batches of 128 keys
+// drawn at random from the table; the gap opens once the table no longer
+// fits in the last-level cache.
+
+#include <memory>
+
+#include "bench.hpp"
+#include "shm/super_hashmap.hpp"
+
+namespace shm::bench {
+namespace {
+
+constexpr std::size_t batch_size = 128;
+
+template <class Kind>
+void run_kind(context& ctx) {
+    using key_type = typename Kind::type;
+    using map_type = super_hashmap<key_type, std::uint64_t, typename Kind::hash>;
+    const std::string prefix = std::string("batch/super_hashmap/") + Kind::name + "/";
+
+    for (std::size_t n : ctx.sizes(sizeof(typename map_type::value_type))) {
+        auto keys = make_keys<Kind>(n, n);
+        keys.resize(n);
+        map_type map;
+        for (const auto& k : keys) map.emplace(k, 1);
+
+        // Query in a different order than insertion.
+        std::mt19937_64 rng(n);
+        std::vector<key_type> queries(std::max(n, batch_size));
+        for (auto& q : queries) q = keys[rng() % n];
+        const std::size_t ops = queries.size() / batch_size * batch_size;
+        std::span<const key_type> all(queries.data(), ops);
+
+        const auto emit = [&](const char* op, double ns) {
+            ctx.report({"batch", "super_hashmap", Kind::name, op, n, ops, ns});
+        };
+
+        std::vector<typename map_type::iterator> found(batch_size);
+        if (ctx.enabled(prefix + "find_loop")) {
+            emit("find_loop", measure(ctx.reps(ops), ops, [] {}, [&] {
+                     std::uint64_t sum = 0;
+                     for (std::size_t b = 0; b != ops; b += batch_size) {
+                         for (std::size_t i = 0; i != batch_size; ++i) found[i] = map.find(all[b + i]);
+                         for (auto it : found) sum += it->second;
+                     }
+                     do_not_optimize(sum);
+                 }));
+        }
+
+        if (ctx.enabled(prefix + "find_batch")) {
+            emit("find_batch", measure(ctx.reps(ops), ops, [] {}, [&] {
+                     std::uint64_t sum = 0;
+                     for (std::size_t b = 0; b != ops; b += batch_size) {
+                         map.find_batch(all.subspan(b, batch_size), found);
+                         for (auto it : found) sum += it->second;
+                     }
+                     do_not_optimize(sum);
+                 }));
+        }
+
+        if (ctx.enabled(prefix + "contains_batch")) {
+            std::unique_ptr<bool[]> present(new bool[batch_size]);
+            emit("contains_batch", measure(ctx.reps(ops), ops, [] {}, [&] {
+                     std::size_t hits = 0;
+                     for (std::size_t b = 0; b != ops; b += batch_size) {
+                         hits += map.contains_batch(all.subspan(b, batch_size), std::span(present.get(), batch_size));
+                     }
+                     do_not_optimize(hits);
+                 }));
+        }
+    }
+}
+
+void batch_suite(context& ctx) {
+    run_kind<key_kind<std::uint64_t>>(ctx);
+    run_kind<key_kind<short_string>>(ctx);
+}
+
+SHM_BENCH_SUITE("batch", batch_suite);
+
+}  // namespace
+}  // namespace shm::bench
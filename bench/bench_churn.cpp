@@ -0,0 +1,98 @@
+// Steady-state erase/insert churn, as in a session table: the table holds
+// n live keys, and each cycle erases the oldest and inserts a fresh one.
+// Lookup cost is sampled after 0, 1, 4, 16 (and, without --quick, 64) * n
+// cycles; with tombstones piling up it would drift upwards between
+// rehashes, without them it stays flat.
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+#include "shm/super_hashmap.hpp"
+
+namespace shm::bench {
+namespace {
+
+// Distinct 64-bit keys (splitmix64 is a bijection of its counter).
+struct key_source {
+    std::uint64_t state;
+
+    std::uint64_t operator()() noexcept {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+template <class Map>
+void run_map(context& ctx, const char* map_name) {
+    const std::string prefix = std::string("churn/") + map_name + "/int64/";
+    if (!ctx.enabled(prefix + "find_hit") && !ctx.enabled(prefix + "find_miss") && !ctx.enabled(prefix + "cycle")) {
+        return;
+    }
+    const std::size_t last_checkpoint = ctx.opts().quick ? 16 : 64;
+
+    for (std::size_t n : ctx.sizes(sizeof(typename Map::value_type))) {
+        key_source fresh{n};
+        key_source absent{~n};
+        std::deque<std::uint64_t> live;
+        Map map;
+        for (std::size_t i = 0; i != n; ++i) {
+            live.push_back(fresh());
+            map.emplace(live.back(), i);
+        }
+
+        const auto emit = [&](const std::string& op, std::size_t ops, double ns) {
+            ctx.report({"churn", map_name, "int64", op, n, ops, ns});
+        };
+
+        std::size_t done = 0;
+        for (std::size_t checkpoint = 0; checkpoint <= last_checkpoint; checkpoint = checkpoint ? checkpoint * 4 : 1) {
+            if (checkpoint) {
+                const std::size_t cycles = checkpoint * n - done;
+                timer t;
+                for (std::size_t i = 0; i != cycles; ++i) {
+                    map.erase(live.front());
+                    live.pop_front();
+                    live.push_back(fresh());
+                    map.emplace(live.back(), i);
+                }
+                if (ctx.enabled(prefix + "cycle")) {
+                    emit("cycle@" + std::to_string(checkpoint) + "n", cycles, t.elapsed_ns() / static_cast<double>(cycles));
+                }
+                done = checkpoint * n;
+            }
+
+            const std::string at = "@" + std::to_string(checkpoint) + "n";
+            if (ctx.enabled(prefix + "find_hit")) {
+                emit("find_hit" + at, n, measure(ctx.reps(n), n, [] {}, [&] {
+                         std::size_t found = 0;
+                         for (std::uint64_t k : live) found += map.find(k) != map.end();
+                         do_not_optimize(found);
+                     }));
+            }
+            if (ctx.enabled(prefix + "find_miss")) {
+                std::vector<std::uint64_t> misses(n);
+                for (auto& k : misses) k = absent();
+                emit("find_miss" + at, n, measure(ctx.reps(n), n, [] {}, [&] {
+                         std::size_t found = 0;
+                         for (std::uint64_t k : misses) found += map.find(k) != map.end();
+                         do_not_optimize(found);
+                     }));
+            }
+        }
+    }
+}
+
+void churn_suite(context& ctx) {
+    run_map<super_hashmap<std::uint64_t, std::uint64_t>>(ctx, "super_hashmap");
+    run_map<std::unordered_map<std::uint64_t, std::uint64_t>>(ctx, "std::unordered_map");
+}
+
+SHM_BENCH_SUITE("churn", churn_suite);
+
+}  // namespace
+}  // namespace shm::bench
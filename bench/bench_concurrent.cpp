@@ -0,0 +1,113 @@
+// Read-mostly throughput of concurrent_super_hashmap against a single
+// mutex around std::unordered_map, at increasing thread counts, with int64
+// keys (lock-free lookups) and short string keys (lock-free misses only).
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "bench.hpp"
+#include "shm/concurrent_super_hashmap.hpp"
+
+namespace shm::bench {
+namespace {
+
+template <class Key>
+struct locked_unordered_map {
+    bool find(const Key& key, std::uint64_t& out) {
+        std::lock_guard lock(mutex);
+        auto it = map.find(key);
+        if (it == map.end()) return false;
+        out = it->second;
+        return true;
+    }
+    void insert_or_assign(const Key& key, std::uint64_t value) {
+        std::lock_guard lock(mutex);
+        map.insert_or_assign(key, value);
+    }
+
+    std::mutex mutex;
+    std::unordered_map<Key, std::uint64_t> map;
+};
+
+template <class Key>
+struct sharded_map {
+    bool find(const Key& key, std::uint64_t& out) { return map.find(key, out); }
+    void insert_or_assign(const Key& key, std::uint64_t value) { map.insert_or_assign(key, value); }
+
+    concurrent_super_hashmap<Key, std::uint64_t> map;
+};
+
+// Every thread runs ops_per_thread operations, one in 64 of them a write of
+// a key from writes and the rest lookups of a key from reads.
+template <class Map, class Key>
+double run_threads(Map& map, const std::vector<Key>& reads, const std::vector<Key>& writes, unsigned threads,
+                   std::size_t ops_per_thread) {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t != threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::uint64_t x = t * 0x9E3779B97F4A7C15ULL + 1, sum = 0;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (std::size_t i = 0; i != ops_per_thread; ++i) {
+                x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+                if ((x >> 58) == 0) {
+                    map.insert_or_assign(writes[x % writes.size()], i);
+                } else {
+                    std::uint64_t v;
+                    if (map.find(reads[x % reads.size()], v)) sum += v;
+                }
+            }
+            do_not_optimize(sum);
+        });
+    }
+    while (ready.load() != threads) std::this_thread::yield();
+    timer clock;
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+    return clock.elapsed_ns() / static_cast<double>(ops_per_thread * threads);
+}
+
+// read_mostly looks up present keys; miss_mostly looks up absent ones, the
+// case that stays lock-free for keys that are not trivially copyable.
+template <class Map, class Kind>
+void run_map(context& ctx, const char* map_name, std::size_t n) {
+    using key_type = typename key_kind<Kind>::type;
+    const char* key_name = key_kind<Kind>::name;
+    const std::string prefix = std::string("concurrent/") + map_name + "/" + key_name + "/";
+    const auto keys = make_keys<key_kind<Kind>>(n, n);
+    const std::vector<key_type> present(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(n));
+    const std::vector<key_type> absent(keys.begin() + static_cast<std::ptrdiff_t>(n), keys.end());
+    Map map;
+    for (std::size_t i = 0; i != n; ++i) map.insert_or_assign(present[i], i);
+
+    const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t ops = ctx.opts().quick ? 1 << 17 : 1 << 21;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        for (const bool hits : {true, false}) {
+            const std::string op = (hits ? "read_mostly_t" : "miss_mostly_t") + std::to_string(threads);
+            if (ctx.enabled(prefix + op)) {
+                // Aggregate throughput, reported as wall-clock ns per operation.
+                ctx.report({"concurrent", map_name, key_name, op, n, ops * threads,
+                            run_threads(map, hits ? present : absent, present, threads, ops)});
+            }
+        }
+        if (threads == max_threads) break;
+    }
+}
+
+void concurrent_suite(context& ctx) {
+    const std::size_t n = ctx.caches().l2 / 16;
+    run_map<sharded_map<std::uint64_t>, std::uint64_t>(ctx, "concurrent_super_hashmap", n);
+    run_map<locked_unordered_map<std::uint64_t>, std::uint64_t>(ctx, "mutex+std::unordered_map", n);
+    run_map<sharded_map<std::string>, short_string>(ctx, "concurrent_super_hashmap", n);
+    run_map<locked_unordered_map<std::string>, short_string>(ctx, "mutex+std::unordered_map", n);
+}
+
+SHM_BENCH_SUITE("concurrent", concurrent_suite);
+
+}  // namespace
+}  // namespace shm::bench
@@ -0,0 +1,50 @@
+// Per-insert latency while a table grows from empty, comparing the
+// default stop-the-world resize with incremental resizing.
+
+#include <unordered_map>
+
+#include "bench.hpp"
+#include "shm/super_hashmap.hpp"
+
+namespace shm::bench {
+namespace {
+
+using int64_map = super_hashmap<std::uint64_t, std::uint64_t>;
+
+template <class Map>
+void run_map(context& ctx, const char* map_name, std::size_t step) {
+    const std::string prefix = std::string("growth/") + map_name + "/int64/";
+    if (!ctx.enabled(prefix + "insert_p999")) return;
+
+    for (std::size_t n : ctx.sizes(sizeof(typename Map::value_type))) {
+        const auto keys = make_keys<key_kind<std::uint64_t>>(n, n);
+        std::vector<double> latency(n);
+        Map map;
+        if constexpr (requires { map.set_incremental_resize(step); }) map.set_incremental_resize(step);
+        for (std::size_t i = 0; i != n; ++i) {
+            timer t;
+            map.emplace(keys[i], i);
+            latency[i] = t.elapsed_ns();
+        }
+        do_not_optimize(map.size());
+
+        std::sort(latency.begin(), latency.end());
+        const auto emit = [&](const char* op, double ns) {
+            ctx.report({"growth", map_name, "int64", op, n, n, ns});
+        };
+        emit("insert_p50", latency[n / 2]);
+        emit("insert_p999", latency[n - 1 - n / 1000]);
+        emit("insert_max", latency.back());
+    }
+}
+
+void growth_suite(context& ctx) {
+    run_map<int64_map>(ctx, "super_hashmap", 0);
+    run_map<int64_map>(ctx, "super_hashmap/incremental", 16);
+    run_map<std::unordered_map<std::uint64_t, std::uint64_t>>(ctx, "std::unordered_map", 0);
+}
+
+SHM_BENCH_SUITE("growth", growth_suite);
+
+}  // namespace
+}  // namespace shm::bench
@@ -0,0 +1,126 @@
+#include <cstdlib>
+#include <ctime>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "bench.hpp"
+#include "shm/detail/group.hpp"
+
+#ifndef SHM_BENCH_OUTPUT
+#define SHM_BENCH_OUTPUT "bench_output.txt"
+#endif
+
+namespace shm::bench {
+
+cache_sizes detect_cache_sizes() {
+    cache_sizes c{32 << 10, 1 << 20, 32 << 20};
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+    const auto query = [](int name, std::size_t fallback) {
+        const long v = sysconf(name);
+        return v > 0 ? static_cast<std::size_t>(v) : fallback;
+    };
+    c.l1 = query(_SC_LEVEL1_DCACHE_SIZE, c.l1);
+    c.l2 = query(_SC_LEVEL2_CACHE_SIZE, c.l2);
+    c.llc = query(_SC_LEVEL3_CACHE_SIZE, c.l2);
+#endif
+    return c;
+}
+
+context::context(options opts, std::FILE* out) : opts_(std::move(opts)), caches_(detect_cache_sizes()), out_(out) {}
+
+std::vector<std::size_t> context::sizes(std::size_t bytes_per_element) const {
+    std::vector<std::size_t> targets = {caches_.l1 / 2, caches_.l2 / 2, caches_.llc / 2, caches_.llc * 2,
+                                        caches_.llc * 10};
+    std::vector<std::size_t> out;
+    for (std::size_t bytes : targets) {
+        if (opts_.quick && bytes > caches_.l2) continue;
+        if (opts_.max_bytes && bytes > opts_.max_bytes) continue;
+        const std::size_t n = std::max<std::size_t>(16, bytes / bytes_per_element);
+        if (out.empty() || out.back() < n) out.push_back(n);
+    }
+    return out;
+}
+
+std::size_t context::reps(std::size_t ops_per_rep) const {
+    const std::size_t min_ops = opts_.quick ? std::size_t{1} << 18 : std::size_t{1} << 22;
+    return std::clamp<std::size_t>(min_ops / std::max<std::size_t>(ops_per_rep, 1), 3, 1000);
+}
+
+bool context::enabled(const std::string& name) const {
+    return opts_.filter.empty() || name.find(opts_.filter) != std::string::npos;
+}
+
+void context::report(const result& r) {
+    std::printf("%-10s %-20s %-14s %-12s %12zu %10.2f ns/op\n", r.suite.c_str(), r.map.c_str(), r.key.c_str(),
+                r.op.c_str(), r.size, r.ns_per_op);
+    std::fflush(stdout);
+    std::fprintf(out_,
+                 "{\"type\":\"result\",\"suite\":\"%s\",\"map\":\"%s\",\"key\":\"%s\",\"op\":\"%s\","
+                 "\"size\":%zu,\"ops\":%zu,\"ns_per_op\":%.3f}\n",
+                 r.suite.c_str(), r.map.c_str(), r.key.c_str(), r.op.c_str(), r.size, r.ops, r.ns_per_op);
+    std::fflush(out_);
+}
+
+registrar::registrar(const char* name, suite_fn fn) { suites().push_back({name, fn}); }
+
+std::vector<suite>& suites() {
+    static std::vector<suite> all;
+    return all;
+}
+
+}  // namespace shm::bench
+
+namespace {
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--quick] [--filter=SUBSTR] [--max-mb=N] [--out=PATH]\n"
+                 "  --quick       only working sets up to L2, fewer repetitions\n"
+                 "  --filter      run only cases whose suite/map/key/op name contains SUBSTR\n"
+                 "  --max-mb      cap the working-set sweep at N MiB\n"
+                 "  --out         JSON-lines output file (default " SHM_BENCH_OUTPUT ")\n",
+                 argv0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    shm::bench::options opts;
+    opts.out_path = SHM_BENCH_OUTPUT;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--quick") {
+            opts.quick = true;
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            opts.filter = arg.substr(9);
+        } else if (arg.rfind("--max-mb=", 0) == 0) {
+            opts.max_bytes = std::strtoull(arg.c_str() + 9, nullptr, 10) << 20;
+        } else if (arg.rfind("--out=", 0) == 0) {
+            opts.out_path = arg.substr(6);
+        } else {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    std::FILE* out = std::fopen(opts.out_path.c_str(), "w");
+    if (!out) {
+        std::perror(opts.out_path.c_str());
+        return 1;
+    }
+
+    shm::bench::context ctx(opts, out);
+    const auto& c = ctx.caches();
+    std::fprintf(out,
+                 "{\"type\":\"meta\",\"timestamp\":%lld,\"compiler\":\"%s\",\"group_width\":%zu,"
+                 "\"l1\":%zu,\"l2\":%zu,\"llc\":%zu,\"quick\":%s}\n",
+                 static_cast<long long>(std::time(nullptr)), __VERSION__, shm::detail::group::width, c.l1, c.l2,
+                 c.llc, opts.quick ? "true" : "false");
+
+    for (const auto& s : shm::bench::suites()) s.fn(ctx);
+
+    std::fclose(out);
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Core operations of super_hashmap against std::unordered_map across key
+// types and working-set sizes.
+
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+
+#include "bench.hpp"
+#include "shm/super_hashmap.hpp"
+
+namespace shm::bench {
+namespace {
+
+template <class Map, class Kind>
+void run_map(context& ctx, const char* map_name) {
+    using key_type = typename Kind::type;
+    using value_type = typename Map::value_type;
+    const std::string prefix = std::string("maps/") + map_name + "/" + Kind::name + "/";
+
+    for (std::size_t n : ctx.sizes(sizeof(value_type) + sizeof(key_type))) {
+        const std::vector<key_type> keys = make_keys<Kind>(n, n);
+        const auto hits = keys.begin();
+        const auto misses = keys.begin() + static_cast<std::ptrdiff_t>(n);
+
+        const auto emit = [&](const char* op, std::size_t ops, double ns) {
+            ctx.report({"maps", map_name, Kind::name, op, n, ops, ns});
+        };
+
+        std::unique_ptr<Map> map;
+        const auto build = [&] {
+            map = std::make_unique<Map>();
+            for (auto it = hits; it != misses; ++it) map->emplace(*it, 1);
+        };
+
+        if (ctx.enabled(prefix + "insert")) {
+            emit("insert", n, measure(ctx.reps(n), n, [&] { map = std::make_unique<Map>(); }, [&] {
+                     for (auto it = hits; it != misses; ++it) map->emplace(*it, 1);
+                 }));
+        }
+
+        build();
+
+        if (ctx.enabled(prefix + "find_hit")) {
+            emit("find_hit", n, measure(ctx.reps(n), n, [] {}, [&] {
+                     std::size_t found = 0;
+                     for (auto it = hits; it != misses; ++it) found += map->find(*it) != map->end();
+                     do_not_optimize(found);
+                 }));
+        }
+
+        if (ctx.enabled(prefix + "find_miss")) {
+            emit("find_miss", n, measure(ctx.reps(n), n, [] {}, [&] {
+                     std::size_t found = 0;
+                     for (auto it = misses; it != keys.end(); ++it) found += map->find(*it) != map->end();
+                     do_not_optimize(found);
+                 }));
+        }
+
+        if (ctx.enabled(prefix + "iterate")) {
+            emit("iterate", n, measure(ctx.reps(n), n, [] {}, [&] {
+                     std::uint64_t sum = 0;
+                     for (const auto& kv : *map) sum += kv.second;
+                     do_not_optimize(sum);
+                 }));
+        }
+
+        // Erase one present key and insert one absent key per step; each
+        // repetition swaps the roles of the two halves of the key set.
+        if (ctx.enabled(prefix + "erase_churn")) {
+            bool flipped = false;
+            emit("erase_churn", 2 * n, measure(ctx.reps(2 * n), 2 * n, [] {}, [&] {
+                     const auto out = flipped ? misses : hits;
+                     const auto in = flipped ? hits : misses;
+                     for (std::size_t i = 0; i != n; ++i) {
+                         map->erase(out[static_cast<std::ptrdiff_t>(i)]);
+                         map->emplace(in[static_cast<std::ptrdiff_t>(i)], 1);
+                     }
+                     flipped = !flipped;
+                 }));
+        }
+
+        if (ctx.enabled(prefix + "rehash")) {
+            emit("rehash", n, measure(std::min<std::size_t>(ctx.reps(n), 10), n, build, [&] {
+                     map->rehash(map->bucket_count() * 2);
+                 }));
+        }
+    }
+}
+
+template <class Kind>
+void run_kind(context& ctx) {
+    using key_type = typename Kind::type;
+    using hash = typename Kind::hash;
+    run_map<super_hashmap<key_type, std::uint64_t, hash>, Kind>(ctx, "super_hashmap");
+    // The default seeded shm::hash; key64 has no std::hash to fall back on.
+    if constexpr (!std::is_same_v<key_type, key64>) {
+        run_map<super_hashmap<key_type, std::uint64_t>, Kind>(ctx, "super_hashmap/shm::hash");
+    }
+    run_map<std::unordered_map<key_type, std::uint64_t, hash>, Kind>(ctx, "std::unordered_map");
+}
+
+void maps_suite(context& ctx) {
+    run_kind<key_kind<std::uint64_t>>(ctx);
+    run_kind<key_kind<short_string>>(ctx);
+    run_kind<key_kind<long_string>>(ctx);
+    run_kind<key_kind<struct64>>(ctx);
+}
+
+SHM_BENCH_SUITE("maps", maps_suite);
+
+}  // namespace
+}  // namespace shm::bench
@@ -0,0 +1,69 @@
+// Bulk construction and full scans on the calling thread against the
+// parallel constructor and parallel_for_each, using every hardware thread.
+// The visitor only reads each value, so the scans measure the walk itself.
+
+#include <thread>
+
+#include "bench.hpp"
+#include "shm/super_hashmap.hpp"
+
+namespace shm::bench {
+namespace {
+
+template <class Kind>
+void run_kind(context& ctx) {
+    using key_type = typename Kind::type;
+    using map_type = super_hashmap<key_type, std::uint64_t, typename Kind::hash>;
+    const std::string prefix = std::string("parallel/super_hashmap/") + Kind::name + "/";
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (std::size_t n : ctx.sizes(sizeof(typename map_type::value_type))) {
+        auto keys = make_keys<Kind>(n, n);
+        keys.resize(n);
+        std::vector<std::pair<key_type, std::uint64_t>> rows;
+        rows.reserve(n);
+        for (std::size_t i = 0; i != n; ++i) rows.emplace_back(keys[i], i);
+
+        const auto emit = [&](const char* op, double ns) {
+            ctx.report({"parallel", "super_hashmap", Kind::name, op, n, n, ns});
+        };
+
+        if (ctx.enabled(prefix + "build")) {
+            emit("build", measure(ctx.reps(n), n, [] {}, [&] {
+                     map_type map(rows.begin(), rows.end());
+                     do_not_optimize(map.size());
+                 }));
+        }
+
+        if (ctx.enabled(prefix + "build_parallel")) {
+            emit("build_parallel", measure(ctx.reps(n), n, [] {}, [&] {
+                     map_type map(parallel_build, rows, threads);
+                     do_not_optimize(map.size());
+                 }));
+        }
+
+        const map_type map(rows.begin(), rows.end());
+
+        if (ctx.enabled(prefix + "for_each")) {
+            emit("for_each", measure(ctx.reps(n), n, [] {}, [&] {
+                     for (const auto& kv : map) do_not_optimize(kv.second);
+                 }));
+        }
+
+        if (ctx.enabled(prefix + "parallel_for_each")) {
+            emit("parallel_for_each", measure(ctx.reps(n), n, [] {}, [&] {
+                     map.parallel_for_each([](const auto& kv) { do_not_optimize(kv.second); }, threads);
+                 }));
+        }
+    }
+}
+
+void parallel_suite(context& ctx) {
+    run_kind<key_kind<std::uint64_t>>(ctx);
+    run_kind<key_kind<short_string>>(ctx);
+}
+
+SHM_BENCH_SUITE("parallel", parallel_suite);
+
+}  // namespace
+}  // namespace shm::bench
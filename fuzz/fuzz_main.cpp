@@ -0,0 +1,64 @@
+// Standalone driver for the fuzz targets when libFuzzer is not available.
+// With file arguments it replays each file (e.g. a crash reproducer or a
+// corpus); otherwise it runs -runs=N random inputs of up to -max_len=N
+// bytes from -seed=N, which is enough to replay the fuzzer as a test.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size);
+
+int main(int argc, char** argv) {
+    std::size_t runs = 10000;
+    std::size_t max_len = 4096;
+    std::uint64_t seed = 1;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("-runs=", 0) == 0) {
+            runs = std::strtoull(arg.c_str() + 6, nullptr, 10);
+        } else if (arg.rfind("-max_len=", 0) == 0) {
+            max_len = std::strtoull(arg.c_str() + 9, nullptr, 10);
+        } else if (arg.rfind("-seed=", 0) == 0) {
+            seed = std::strtoull(arg.c_str() + 6, nullptr, 10);
+        } else if (arg.rfind("-", 0) == 0) {
+            std::fprintf(stderr, "usage: %s [-runs=N] [-max_len=N] [-seed=N] [file...]\n", argv[0]);
+            return 2;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (!files.empty()) {
+        for (const auto& path : files) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                std::perror(path.c_str());
+                return 1;
+            }
+            const std::vector<char> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+        }
+        std::printf("replayed %zu file(s)\n", files.size());
+        return 0;
+    }
+
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint8_t> input;
+    for (std::size_t run = 0; run != runs; ++run) {
+        // Half short inputs, half long enough to grow multi-group tables.
+        const std::size_t len = rng() % 2 ? rng() % (max_len + 1) : rng() % (max_len / 16 + 1);
+        input.resize(len);
+        for (auto& b : input) b = static_cast<std::uint8_t>(rng());
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    std::printf("%zu random inputs, seed %llu: ok\n", runs, static_cast<unsigned long long>(seed));
+    return 0;
+}
@@ -0,0 +1,335 @@
+// Differential fuzzer: replays the input as a sequence of operations on one
+// of the tables and on std::unordered_map side by side, and aborts as soon
+// as their observable state differs. The first two bytes pick the
+// configuration (table kind, key range, incremental resizing, hasher,
+// sentinel key); every later operation is one opcode byte followed by its
+// operands. super_hashmap, super_hashset, sentinel_hashmap and
+// sentinel_hashset are covered, since each has its own probing and erase
+// code.
+//
+// Built against libFuzzer with clang (SHM_BUILD_FUZZERS and -fsanitize=fuzzer),
+// or with fuzz_main.cpp as a standalone driver that replays files or
+// random inputs.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "shm/sentinel_hashmap.hpp"
+#include "shm/super_hashmap.hpp"
+#include "shm/super_hashset.hpp"
+
+namespace {
+
+// Consumes the input from the front; past the end everything reads as 0.
+class reader {
+public:
+    reader(const std::uint8_t* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    bool empty() const noexcept { return pos_ == size_; }
+
+    std::uint8_t byte() noexcept { return pos_ < size_ ? data_[pos_++] : 0; }
+
+    std::uint16_t word() noexcept {
+        const std::uint16_t lo = byte();
+        return static_cast<std::uint16_t>(lo | byte() << 8);
+    }
+
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+};
+
+// A hasher that vouches for itself but sends keys to a handful of home
+// slots, so that probe sequences run long and wrap around the table.
+struct clumping_hash {
+    using is_avalanching = void;
+    std::size_t operator()(std::uint64_t k) const noexcept { return (k % 5) * 0x9E3779B97F4A7C15ULL; }
+};
+
+[[noreturn]] void mismatch(const char* what, int line) {
+    std::fprintf(stderr, "fuzz_map: %s (line %d)\n", what, line);
+    std::abort();
+}
+
+#define FUZZ_CHECK(cond)                        \
+    do {                                        \
+        if (!(cond)) mismatch(#cond, __LINE__); \
+    } while (0)
+
+// Sets are checked against a map whose values stay 0.
+using reference_map = std::unordered_map<std::uint64_t, std::uint64_t>;
+
+template <class Table>
+constexpr bool is_set = std::is_same_v<typename Table::key_type, typename Table::value_type>;
+
+// The super tables; the sentinel ones have no incremental resizing and no
+// batch lookup.
+template <class Table>
+constexpr bool is_super = requires(Table& t) { t.set_incremental_resize(1); };
+
+template <class Table, class Elem>
+std::uint64_t key_of(const Elem& e) {
+    if constexpr (is_set<Table>) {
+        return e;
+    } else {
+        return e.first;
+    }
+}
+
+template <class Table, class Elem>
+std::uint64_t value_of(const Elem& e) {
+    if constexpr (is_set<Table>) {
+        return 0;
+    } else {
+        return e.second;
+    }
+}
+
+template <class Table>
+void check_same(const Table& table, const reference_map& ref) {
+    FUZZ_CHECK(table.size() == ref.size());
+    FUZZ_CHECK(table.empty() == ref.empty());
+    std::size_t seen = 0;
+    for (const auto& e : table) {
+        const auto it = ref.find(key_of<Table>(e));
+        FUZZ_CHECK(it != ref.end() && it->second == value_of<Table>(e));
+        ++seen;
+    }
+    FUZZ_CHECK(seen == ref.size());
+}
+
+// Inserts k unless present, with value v for maps; returns whether it was
+// inserted and checks the element the table points at.
+template <class Table>
+bool insert(Table& table, std::uint64_t k, std::uint64_t v, bool assign) {
+    if constexpr (is_set<Table>) {
+        const auto [it, inserted] = table.insert(k);
+        FUZZ_CHECK(*it == k);
+        return inserted;
+    } else {
+        const auto [it, inserted] = assign ? table.insert_or_assign(k, v) : table.try_emplace(k, v);
+        FUZZ_CHECK((*it).first == k);
+        if (assign) FUZZ_CHECK((*it).second == v);
+        return inserted;
+    }
+}
+
+template <class Table>
+void run(reader& in, std::uint64_t key_mask, std::uint64_t special, std::size_t step) {
+    Table table;
+    reference_map ref;
+    if constexpr (is_super<Table>) table.set_incremental_resize(step);
+    // Narrow key ranges make collisions and re-inserts of erased keys
+    // common; one key in sixteen is the special one (a sentinel table's
+    // Empty value).
+    const auto key = [&]() -> std::uint64_t {
+        const std::uint16_t w = in.word();
+        return (w >> 12) == 0xF ? special : w & key_mask;
+    };
+
+    while (!in.empty()) {
+        switch (in.byte() % 16) {
+            case 0:
+            case 1: {
+                const auto k = key();
+                const std::uint64_t v = is_set<Table> ? 0 : in.word();
+                FUZZ_CHECK(insert(table, k, v, false) == ref.try_emplace(k, v).second);
+                break;
+            }
+            case 2: {
+                const auto k = key();
+                const std::uint64_t v = is_set<Table> ? 0 : in.word();
+                FUZZ_CHECK(insert(table, k, v, true) == ref.insert_or_assign(k, v).second);
+                break;
+            }
+            case 3: {
+                const auto k = key();
+                if constexpr (is_set<Table>) {
+                    FUZZ_CHECK(table.emplace(k).second == ref.emplace(k, 0).second);
+                } else {
+                    table[k] += 1;
+                    ref[k] += 1;
+                }
+                break;
+            }
+            case 4:
+            case 5: {
+                const auto k = key();
+                FUZZ_CHECK(table.erase(k) == ref.erase(k));
+                break;
+            }
+            case 6: {
+                // Erase by iterator. The super tables return the element
+                // that followed; the sentinel ones shift a later element
+                // into the hole and may return that instead.
+                const auto k = key();
+                const auto it = table.find(k);
+                FUZZ_CHECK((it == table.end()) == !ref.count(k));
+                if (it != table.end()) {
+                    const auto next = std::next(it);
+                    const bool at_end = next == table.end();
+                    const std::uint64_t next_key = at_end ? 0 : key_of<Table>(*next);
+                    const auto after = table.erase(it);
+                    if constexpr (is_super<Table>) {
+                        FUZZ_CHECK(at_end ? after == table.end() : key_of<Table>(*after) == next_key);
+                    }
+                    ref.erase(k);
+                }
+                break;
+            }
+            case 7:
+            case 8: {
+                const auto k = key();
+                const auto it = table.find(k);
+                const auto r = ref.find(k);
+                FUZZ_CHECK((it == table.end()) == (r == ref.end()));
+                if (r != ref.end()) FUZZ_CHECK(value_of<Table>(*it) == r->second);
+                FUZZ_CHECK(table.count(k) == ref.count(k));
+                FUZZ_CHECK(table.contains(k) == (r != ref.end()));
+                break;
+            }
+            case 9: {
+                const std::size_t n = in.byte() % 64;
+                std::vector<std::uint64_t> keys(n);
+                for (auto& k : keys) k = key();
+                if constexpr (is_super<Table>) {
+                    std::vector<typename Table::iterator> found(n);
+                    table.find_batch(keys, found);
+                    for (std::size_t i = 0; i != n; ++i) FUZZ_CHECK(found[i] == table.find(keys[i]));
+                } else {
+                    for (const auto k : keys) FUZZ_CHECK(table.contains(k) == (ref.count(k) != 0));
+                }
+                break;
+            }
+            case 10: {
+                // Erasing while iterating must visit every element once.
+                const std::uint64_t mod = in.byte() % 7 + 2;
+                const auto pred = [mod](const auto& e) { return key_of<Table>(e) % mod == 0; };
+                const std::size_t expected = std::erase_if(ref, [mod](const auto& kv) { return kv.first % mod == 0; });
+                if (in.byte() % 2) {
+                    FUZZ_CHECK(erase_if(table, pred) == expected);
+                } else {
+                    const std::size_t old_size = table.size();
+                    std::size_t visited = 0;
+                    for (auto it = table.begin(); it != table.end(); ++visited) {
+                        if (pred(*it)) {
+                            it = table.erase(it);
+                        } else {
+                            ++it;
+                        }
+                    }
+                    FUZZ_CHECK(visited == old_size);
+                }
+                break;
+            }
+            case 11:
+                table.rehash(in.word() % 4096);
+                break;
+            case 12:
+                table.reserve(in.word() % 4096);
+                break;
+            case 13: {
+                // Copies, moves and swaps must carry every element (and, for
+                // a table mid-resize, both arrays) across.
+                Table copy(table);
+                check_same(copy, ref);
+                FUZZ_CHECK(copy == table);
+                Table moved(std::move(copy));
+                check_same(moved, ref);
+                Table other;
+                other.swap(moved);
+                check_same(other, ref);
+                table = std::move(other);
+                break;
+            }
+            case 14:
+                if (in.byte() % 8 == 0) {
+                    table.clear();
+                    ref.clear();
+                } else if constexpr (is_super<Table>) {
+                    table.finish_resize();
+                }
+                break;
+            default:
+                check_same(table, ref);
+                break;
+        }
+        FUZZ_CHECK(table.size() == ref.size());
+    }
+    check_same(table, ref);
+}
+
+// The tables of one kind, instantiated with the hasher chosen by the input.
+template <template <class> class Table>
+void run_with_hash(reader& in, std::uint8_t hasher, std::uint64_t key_mask, std::uint64_t special, std::size_t step) {
+    switch (hasher % 3) {
+        case 0:
+            run<Table<shm::hash<std::uint64_t>>>(in, key_mask, special, step);
+            break;
+        case 1:
+            run<Table<std::hash<std::uint64_t>>>(in, key_mask, special, step);
+            break;
+        default:
+            run<Table<clumping_hash>>(in, key_mask, special, step);
+            break;
+    }
+}
+
+template <class Hash>
+using super_map = shm::super_hashmap<std::uint64_t, std::uint64_t, Hash>;
+template <class Hash>
+using super_set = shm::super_hashset<std::uint64_t, Hash>;
+
+// Empty values inside the fuzzed key ranges, so that the out-of-band
+// element is exercised.
+template <std::uint64_t Empty>
+struct sentinel {
+    template <class Hash>
+    using map = shm::sentinel_hashmap<std::uint64_t, std::uint64_t, Hash,
+                                      std::allocator<std::pair<const std::uint64_t, std::uint64_t>>, Empty>;
+    template <class Hash>
+    using set = shm::sentinel_hashset<std::uint64_t, Hash, std::allocator<std::uint64_t>, Empty>;
+};
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    reader in(data, size);
+    const std::uint8_t kind = in.byte();
+    const std::uint8_t options = in.byte();
+    const std::uint64_t key_mask = (options & 1) ? 0xFF : 0xFFF;
+    const std::size_t step = (options & 2) ? 1 + (kind >> 2) : 0;
+    const bool high_empty = options & 4;
+    switch (kind % 4) {
+        case 0:
+            run_with_hash<super_map>(in, options >> 3, key_mask, ~std::uint64_t{0}, step);
+            break;
+        case 1:
+            run_with_hash<super_set>(in, options >> 3, key_mask, ~std::uint64_t{0}, step);
+            break;
+        case 2:
+            if (high_empty) {
+                run_with_hash<sentinel<0x7F>::map>(in, options >> 3, key_mask, 0x7F, step);
+            } else {
+                run_with_hash<sentinel<0>::map>(in, options >> 3, key_mask, 0, step);
+            }
+            break;
+        default:
+            if (high_empty) {
+                run_with_hash<sentinel<0x7F>::set>(in, options >> 3, key_mask, 0x7F, step);
+            } else {
+                run_with_hash<sentinel<0>::set>(in, options >> 3, key_mask, 0, step);
+            }
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+namespace shm {
+
+// Monotonic bump allocator. Memory is handed out from chunks taken from an
+// upstream resource, each twice the size of the last; deallocation does
+// nothing and everything is returned at once by release() or the
+// destructor (reset() keeps one chunk for reuse). An optional
+// caller-supplied buffer (e.g. on the stack) is used before any chunk is
+// allocated.
+//
+// Meant for short-lived tables: with an arena allocator and trivially
+// destructible keys and values, destroying a table does no work at all.
+//
+//   shm::arena scratch;
+//   shm::super_hashmap<std::uint64_t, std::uint32_t, std::hash<std::uint64_t>, std::equal_to<std::uint64_t>,
+//                      shm::arena_allocator<std::pair<const std::uint64_t, std::uint32_t>>> seen(scratch);
+//
+// It is also a std::pmr::memory_resource, so it can back pmr containers.
+// Not thread-safe.
+class arena final : public std::pmr::memory_resource {
+public:
+    explicit arena(std::size_t initial_chunk = 4096,
+                   std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+        : upstream_(upstream), initial_chunk_(std::max<std::size_t>(initial_chunk, 256)), next_chunk_(initial_chunk_) {}
+
+    arena(void* buffer, std::size_t bytes,
+          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+        : arena(std::max<std::size_t>(bytes, 256) * 2, upstream) {
+        buffer_ = static_cast<char*>(buffer);
+        buffer_size_ = bytes;
+        cur_ = buffer_;
+        end_ = buffer_ + bytes;
+    }
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    ~arena() override { release(); }
+
+    // Frees every chunk. Everything allocated from the arena becomes invalid.
+    void release() noexcept {
+        while (chunks_) {
+            chunk* c = chunks_;
+            chunks_ = c->next;
+            upstream_->deallocate(c, c->bytes, c->alignment);
+        }
+        cur_ = buffer_;
+        end_ = buffer_ ? buffer_ + buffer_size_ : nullptr;
+        next_chunk_ = initial_chunk_;
+    }
+
+    // Like release(), but keeps the newest (largest) chunk and reuses it, so
+    // an arena reset between requests stops calling upstream once it has
+    // grown to the working size.
+    void reset() noexcept {
+        if (!chunks_) {
+            release();
+            return;
+        }
+        chunk* keep = chunks_;
+        chunks_ = keep->next;
+        release();
+        keep->next = nullptr;
+        chunks_ = keep;
+        cur_ = reinterpret_cast<char*>(keep) + sizeof(chunk);
+        end_ = reinterpret_cast<char*>(keep) + keep->bytes;
+        next_chunk_ = keep->bytes * 2;
+    }
+
+    std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+private:
+    template <class T>
+    friend class arena_allocator;
+
+    struct chunk {
+        chunk* next;
+        std::size_t bytes;
+        std::size_t alignment;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override { return bump(bytes, alignment); }
+
+    void* bump(std::size_t bytes, std::size_t alignment) {
+        void* p = cur_;
+        std::size_t space = static_cast<std::size_t>(end_ - cur_);
+        if (cur_ && std::align(alignment, bytes, p, space)) [[likely]] {
+            cur_ = static_cast<char*>(p) + bytes;
+            return p;
+        }
+        return allocate_chunk(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) noexcept override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void* allocate_chunk(std::size_t bytes, std::size_t alignment) {
+        const std::size_t header = (sizeof(chunk) + alignment - 1) & ~(alignment - 1);
+        if (bytes > std::numeric_limits<std::size_t>::max() / 2 - header) throw std::bad_alloc();
+        const std::size_t size = std::max(next_chunk_, header + bytes);
+        const std::size_t chunk_alignment = std::max(alignment, alignof(std::max_align_t));
+        auto* c = static_cast<chunk*>(upstream_->allocate(size, chunk_alignment));
+        c->next = chunks_;
+        c->bytes = size;
+        c->alignment = chunk_alignment;
+        chunks_ = c;
+        next_chunk_ = size <= std::numeric_limits<std::size_t>::max() / 2 ? size * 2 : size;
+        char* p = reinterpret_cast<char*>(c) + header;
+        cur_ = p + bytes;
+        end_ = reinterpret_cast<char*>(c) + size;
+        return p;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    chunk* chunks_ = nullptr;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    char* buffer_ = nullptr;
+    std::size_t buffer_size_ = 0;
+    std::size_t initial_chunk_;
+    std::size_t next_chunk_;
+};
+
+// Allocator drawing from an arena. Unlike polymorphic_allocator it calls
+// the arena directly, without a virtual call, and deallocate is a no-op.
+// Allocators compare equal when they share an arena; like
+// polymorphic_allocator, they do not propagate on assignment or swap.
+template <class T>
+class arena_allocator {
+public:
+    using value_type = T;
+
+    arena_allocator(arena& a) noexcept : arena_(&a) {}
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) noexcept : arena_(&other.resource()) {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(arena_->bump(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) noexcept {}
+
+    arena& resource() const noexcept { return *arena_; }
+
+    template <class U>
+    friend bool operator==(const arena_allocator& a, const arena_allocator<U>& b) noexcept {
+        return &a.resource() == &b.resource();
+    }
+
+private:
+    arena* arena_;
+};
+
+}  // namespace shm
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "shm/hash.hpp"
+#include "shm/sentinel_hashmap.hpp"
+#include "shm/super_hashmap.hpp"
+#include "shm/super_hashset.hpp"
+
+namespace shm {
+
+// Picks the smallest layout for the key and value types at compile time:
+// sentinel_hashmap / sentinel_hashset (flat key and value arrays, no
+// control bytes) for integer keys with small trivially copyable values,
+// super_hashmap / super_hashset otherwise. Code written against these
+// aliases should stick to what both layouts offer: find, contains, count,
+// insert, try_emplace, insert_or_assign, operator[], at, erase, reserve
+// and memory_usage.
+//
+// Iteration is where the map layouts differ: the sentinel map's iterators
+// yield std::pair<const K&, V&> proxies by value rather than references to
+// a stored value_type. Portable loops read with it->first / it->second,
+// `const auto& [k, v]` or `auto [k, v]`, and write with it->second = x or
+// `auto&& [k, v]`. `auto& [k, v]` and value_type& / value_type* do not
+// compile for the sentinel layout, and assigning to v bound by
+// `auto [k, v]` writes through for it but only to a copy for the other.
+namespace detail {
+
+// Sets (V = void) have no value to weigh.
+template <class V>
+inline constexpr bool compact_small_value = sizeof(V) <= 16;
+template <>
+inline constexpr bool compact_small_value<void> = true;
+
+// Only names sentinel_hashmap when it can be instantiated: its Empty
+// parameter needs an integer key type.
+template <class K, class V, class Hash, bool Sentinel = sentinel_eligible<K, V> && compact_small_value<V>>
+struct compact_select {
+    using map = super_hashmap<K, V, Hash>;
+    using set = super_hashset<K, Hash>;
+};
+
+template <class K, class V, class Hash>
+struct compact_select<K, V, Hash, true> {
+    using map = sentinel_hashmap<K, V, Hash>;
+    using set = sentinel_hashset<K, Hash>;
+};
+
+}  // namespace detail
+
+template <class K, class V, class Hash = shm::hash<K>>
+using compact_hashmap = typename detail::compact_select<K, V, Hash>::map;
+
+template <class K, class Hash = shm::hash<K>>
+using compact_hashset = typename detail::compact_select<K, void, Hash>::set;
+
+}  // namespace shm
@@ -0,0 +1,723 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "shm/detail/ctrl.hpp"
+#include "shm/detail/group.hpp"
+#include "shm/detail/mix.hpp"
+#include "shm/detail/raw_hash_table.hpp"
+#include "shm/hash.hpp"
+
+#if defined(SHM_GROUP_SSE2) || defined(SHM_GROUP_AVX2)
+#include <emmintrin.h>
+#endif
+
+namespace shm {
+
+namespace detail {
+
+inline constexpr std::size_t cache_line_size = 64;
+
+inline void cpu_relax() noexcept {
+#if defined(SHM_GROUP_SSE2) || defined(SHM_GROUP_AVX2)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+}  // namespace detail
+
+// Hash map for many threads sharing one table. Keys are spread over a
+// power-of-two number of shards by hash bits just below the 7-bit tag; each
+// shard is an independent open-addressing table with its own lock.
+//
+// Writers lock only their shard. When both K and V are trivially copyable,
+// readers take no lock at all: they probe optimistically under a per-shard
+// sequence counter (seqlock) and retry if a writer ran concurrently, falling
+// back to the shard lock after a few failed attempts. Every byte such a
+// reader may look at is then read and written with relaxed atomic
+// accesses, so the race is benign under the memory model and not only in
+// practice.
+//
+// Other keys and values (std::string, say) cannot be copied out while a
+// writer may be changing them, so a lookup that finds its key takes the
+// shard lock in shared mode. When they move without throwing, the probe
+// for the key's tag still runs optimistically over the control bytes
+// alone, and a lookup whose tag appears nowhere on the probe sequence (a
+// miss, most of the time) returns without taking the lock.
+//
+// Since optimistic readers may still be probing a table after it has been
+// replaced by a larger one, replaced tables are then retired rather than
+// freed. Only growth retires a table (tombstones are purged in place), and
+// growth is geometric, so they never total more than the live table; they
+// are released by reclaim() and by the destructor.
+//
+// Nothing here hands out references or iterators into the table: lookups
+// copy the mapped value out, and in-place access goes through callbacks run
+// under the shard lock.
+template <class K, class V, class Hash = shm::hash<K>, class Eq = std::equal_to<K>,
+          class Alloc = std::allocator<std::pair<const K, V>>>
+class concurrent_super_hashmap {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+
+    // Whether lookups run without taking any lock.
+    static constexpr bool lock_free_reads = std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>;
+
+    // Whether lookups of absent keys usually run without taking any lock.
+    static constexpr bool lock_free_misses =
+        lock_free_reads || (std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>);
+
+private:
+    using ctrl_t = detail::ctrl_t;
+    using group = detail::group;
+    using probe_seq = detail::probe_seq;
+
+    struct entry {
+        template <class KArg, class... Args>
+        explicit entry(KArg&& k, Args&&... args) : key(std::forward<KArg>(k)), value(std::forward<Args>(args)...) {}
+
+        K key;
+        V value;
+    };
+
+    // A shard's table: header, control bytes and slots in one allocation,
+    // published through a single pointer so that readers always see a
+    // capacity that matches the arrays.
+    struct table {
+        std::size_t capacity;
+        std::size_t size;
+        std::size_t growth_left;
+        ctrl_t* ctrl;
+        entry* slots;
+    };
+
+    static constexpr std::size_t block_align = std::max({alignof(table), alignof(entry), alignof(std::max_align_t)});
+    struct alignas(block_align) block {
+        unsigned char bytes[block_align];
+    };
+
+    using alloc_traits = std::allocator_traits<Alloc>;
+    using entry_alloc = typename alloc_traits::template rebind_alloc<entry>;
+    using entry_traits = std::allocator_traits<entry_alloc>;
+    using block_alloc = typename alloc_traits::template rebind_alloc<block>;
+    using block_traits = std::allocator_traits<block_alloc>;
+
+    struct alignas(detail::cache_line_size) shard {
+        mutable std::shared_mutex mutex;
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<table*> current{nullptr};
+        std::vector<table*> retired;
+    };
+
+    // Holds a shard's lock and keeps its sequence counter odd while a
+    // mutation is in progress, including when the mutation throws.
+    class write_section {
+    public:
+        explicit write_section(shard& s) : shard_(s) {
+            const std::uint64_t seq = shard_.seq.load(std::memory_order_relaxed);
+            shard_.seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        ~write_section() { shard_.seq.store(shard_.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+        write_section(const write_section&) = delete;
+        write_section& operator=(const write_section&) = delete;
+
+    private:
+        shard& shard_;
+    };
+
+    static constexpr int optimistic_attempts = 8;
+
+    template <class Key>
+    using key_arg = detail::key_arg<Hash, Eq, Key, K>;
+
+public:
+    // shard_count is rounded up to a power of two; by default four shards
+    // per hardware thread.
+    explicit concurrent_super_hashmap(std::size_t shard_count = default_shard_count(), const Hash& hash = Hash(),
+                                      const Eq& eq = Eq(), const Alloc& alloc = Alloc())
+        : hash_(hash), eq_(eq), alloc_(alloc) {
+        shard_count = std::bit_ceil(std::clamp<std::size_t>(shard_count, 1, std::size_t{1} << 16));
+        shard_bits_ = static_cast<unsigned>(std::countr_zero(shard_count));
+        shards_ = std::make_unique<shard[]>(shard_count);
+    }
+
+    concurrent_super_hashmap(const concurrent_super_hashmap&) = delete;
+    concurrent_super_hashmap& operator=(const concurrent_super_hashmap&) = delete;
+
+    ~concurrent_super_hashmap() {
+        for (std::size_t i = 0; i != shard_count(); ++i) {
+            shard& s = shards_[i];
+            destroy_table(s.current.load(std::memory_order_relaxed));
+            for (table* t : s.retired) deallocate_table(t);
+        }
+    }
+
+    static std::size_t default_shard_count() noexcept {
+        return 4 * std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::size_t shard_count() const noexcept { return std::size_t{1} << shard_bits_; }
+
+    // Copies the mapped value for key into out; returns false if absent.
+    template <class Key = K>
+    bool find(const key_arg<Key>& key, V& out) const {
+        return visit<Key>(key, [&](const V& v) { out = v; });
+    }
+
+    template <class Key = K>
+    std::optional<V> get(const key_arg<Key>& key) const {
+        std::optional<V> out;
+        visit<Key>(key, [&](const V& v) { out.emplace(v); });
+        return out;
+    }
+
+    template <class Key = K>
+    bool contains(const key_arg<Key>& key) const {
+        return visit<Key>(key, [](const V&) {});
+    }
+
+    template <class Key = K>
+    size_type count(const key_arg<Key>& key) const {
+        return contains<Key>(key) ? 1 : 0;
+    }
+
+    // Calls f(const V&) with the value mapped to key, if any. With lock-free
+    // reads, f receives a private copy taken after validation; otherwise it
+    // runs under the shard's shared lock and must not call back into the map.
+    // With lock-free misses, the lock is only taken once the key's tag has
+    // been seen.
+    template <class Key = K, class F>
+    bool visit(const key_arg<Key>& key, F&& f) const {
+        const std::size_t hash = hash_of(key);
+        const shard& s = shard_for(hash);
+        if constexpr (lock_free_reads) {
+            alignas(V) unsigned char copy[sizeof(V)];
+            for (int attempt = 0; attempt != optimistic_attempts; ++attempt) {
+                const std::uint64_t seq = s.seq.load(std::memory_order_acquire);
+                if (seq & 1) {
+                    detail::cpu_relax();
+                    continue;
+                }
+                const bool found = find_optimistic(s.current.load(std::memory_order_acquire), key, hash, copy);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) != seq) continue;
+                if (found) f(*std::launder(reinterpret_cast<const V*>(copy)));
+                return found;
+            }
+        } else if constexpr (lock_free_misses) {
+            for (int attempt = 0; attempt != optimistic_attempts; ++attempt) {
+                const std::uint64_t seq = s.seq.load(std::memory_order_acquire);
+                if (seq & 1) {
+                    detail::cpu_relax();
+                    continue;
+                }
+                const bool tag_seen = probe_tag(s.current.load(std::memory_order_acquire), hash);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) != seq) continue;
+                if (!tag_seen) return false;
+                break;
+            }
+        }
+        std::shared_lock lock(s.mutex);
+        const table* t = s.current.load(std::memory_order_relaxed);
+        const entry* e = find_entry(t, key, hash);
+        if (e) f(e->value);
+        return e != nullptr;
+    }
+
+    // Inserts (key, V(args...)) unless key is present. Returns whether an
+    // element was inserted.
+    template <class... Args>
+    bool try_emplace(const K& key, Args&&... args) {
+        return emplace_impl(key, key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    bool try_emplace(K&& key, Args&&... args) {
+        return emplace_impl(key, std::move(key), std::forward<Args>(args)...);
+    }
+
+    bool insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    bool insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+
+    // Returns true if the key was inserted, false if an existing value was
+    // assigned.
+    template <class M>
+    bool insert_or_assign(const K& key, M&& value) {
+        const std::size_t hash = hash_of(key);
+        shard& s = shard_for(hash);
+        std::unique_lock lock(s.mutex);
+        if (entry* e = find_entry(s.current.load(std::memory_order_relaxed), key, hash)) {
+            write_section w(s);
+            update_value(e, [&](V& v) { v = std::forward<M>(value); });
+            return false;
+        }
+        insert_new(s, hash, key, std::forward<M>(value));
+        return true;
+    }
+
+    // Runs f(V&) on the value mapped to key under the shard's exclusive
+    // lock. Returns false if the key is absent.
+    template <class Key = K, class F>
+    bool modify(const key_arg<Key>& key, F&& f) {
+        const std::size_t hash = hash_of(key);
+        shard& s = shard_for(hash);
+        std::unique_lock lock(s.mutex);
+        entry* e = find_entry(s.current.load(std::memory_order_relaxed), key, hash);
+        if (!e) return false;
+        write_section w(s);
+        update_value(e, f);
+        return true;
+    }
+
+    template <class Key = K>
+    size_type erase(const key_arg<Key>& key) {
+        const std::size_t hash = hash_of(key);
+        shard& s = shard_for(hash);
+        std::unique_lock lock(s.mutex);
+        table* t = s.current.load(std::memory_order_relaxed);
+        entry* e = find_entry(t, key, hash);
+        if (!e) return 0;
+        const std::size_t i = static_cast<std::size_t>(e - t->slots);
+        write_section w(s);
+        if (detail::was_never_full(t->ctrl, t->capacity, i)) {
+            set_ctrl(t, i, detail::ctrl_empty);
+            ++t->growth_left;
+        } else {
+            set_ctrl(t, i, detail::ctrl_deleted);
+        }
+        --t->size;
+        entry_alloc alloc(alloc_);
+        entry_traits::destroy(alloc, e);
+        return 1;
+    }
+
+    // Calls f(const K&, const V&) for every element, one shard at a time
+    // under that shard's shared lock. Elements inserted or erased
+    // concurrently may or may not be visited.
+    template <class F>
+    void for_each(F&& f) const {
+        for (std::size_t i = 0; i != shard_count(); ++i) {
+            std::shared_lock lock(shards_[i].mutex);
+            const table* t = shards_[i].current.load(std::memory_order_relaxed);
+            if (!t) continue;
+            for (std::size_t j = 0; j != t->capacity; ++j) {
+                if (detail::is_full(t->ctrl[j])) f(t->slots[j].key, t->slots[j].value);
+            }
+        }
+    }
+
+    // Sum of the shard sizes; only a snapshot while writers are active.
+    size_type size() const {
+        size_type n = 0;
+        for (std::size_t i = 0; i != shard_count(); ++i) {
+            std::shared_lock lock(shards_[i].mutex);
+            if (const table* t = shards_[i].current.load(std::memory_order_relaxed)) n += t->size;
+        }
+        return n;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Bytes held from the allocator: the shard array and every shard's
+    // table, including tables retired by growth and not yet reclaimed.
+    size_type memory_usage() const {
+        size_type bytes = shard_count() * sizeof(shard);
+        for (std::size_t i = 0; i != shard_count(); ++i) {
+            std::shared_lock lock(shards_[i].mutex);
+            if (const table* t = shards_[i].current.load(std::memory_order_relaxed)) {
+                bytes += alloc_blocks(t->capacity) * sizeof(block);
+            }
+            for (const table* t : shards_[i].retired) bytes += alloc_blocks(t->capacity) * sizeof(block);
+        }
+        return bytes;
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i != shard_count(); ++i) {
+            shard& s = shards_[i];
+            std::unique_lock lock(s.mutex);
+            table* t = s.current.load(std::memory_order_relaxed);
+            if (!t || t->size == 0) continue;
+            write_section w(s);
+            destroy_elements(t);
+            reset_ctrl(t);
+            t->size = 0;
+            t->growth_left = detail::capacity_to_growth(t->capacity);
+        }
+    }
+
+    // Sizes every shard for an even share of count elements.
+    void reserve(size_type count) {
+        const std::size_t per_shard = (count + shard_count() - 1) / shard_count();
+        for (std::size_t i = 0; i != shard_count(); ++i) {
+            shard& s = shards_[i];
+            std::unique_lock lock(s.mutex);
+            const table* t = s.current.load(std::memory_order_relaxed);
+            if (!t || t->size + t->growth_left < per_shard) grow(s, detail::growth_to_capacity(per_shard));
+        }
+    }
+
+    // Frees the tables retired by growth. Only safe while no other thread
+    // is reading from the map.
+    void reclaim() {
+        for (std::size_t i = 0; i != shard_count(); ++i) {
+            shard& s = shards_[i];
+            std::unique_lock lock(s.mutex);
+            for (table* t : s.retired) deallocate_table(t);
+            s.retired.clear();
+        }
+    }
+
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+    allocator_type get_allocator() const { return alloc_; }
+
+private:
+    template <class Key>
+    std::size_t hash_of(const Key& key) const {
+        return detail::hash_value(hash_, key);
+    }
+
+    // Shard bits sit right below the 7 bits used for the control-byte tag,
+    // so they stay independent of both the tag and the in-shard position.
+    shard& shard_for(std::size_t hash) const noexcept {
+        constexpr unsigned tag_shift = sizeof(std::size_t) * 8 - 7;
+        return shards_[(hash >> (tag_shift - shard_bits_)) & (shard_count() - 1)];
+    }
+
+    template <class KArg, class... Args>
+    bool emplace_impl(const K& key, KArg&& k, Args&&... args) {
+        const std::size_t hash = hash_of(key);
+        shard& s = shard_for(hash);
+        std::unique_lock lock(s.mutex);
+        if (find_entry(s.current.load(std::memory_order_relaxed), key, hash)) return false;
+        insert_new(s, hash, std::forward<KArg>(k), std::forward<Args>(args)...);
+        return true;
+    }
+
+    // Caller holds the shard lock and has checked the key is absent. Any
+    // growth happens before the write section: the new table is filled
+    // while readers keep using the old one, which is left untouched.
+    template <class... Args>
+    void insert_new(shard& s, std::size_t hash, Args&&... args) {
+        table* t = s.current.load(std::memory_order_relaxed);
+        std::size_t i = t ? find_first_non_full(t, hash) : 0;
+        if (!t || (t->growth_left == 0 && !detail::is_deleted(t->ctrl[i]))) {
+            if (!t) {
+                grow(s, detail::min_capacity);
+            } else if (t->size * 32 <= t->capacity * 25) {
+                purge(s, t);
+            } else {
+                grow(s, t->capacity * 2 + 1);
+            }
+            t = s.current.load(std::memory_order_relaxed);
+            i = find_first_non_full(t, hash);
+        }
+        write_section w(s);
+        if constexpr (lock_free_reads) {
+            const entry e(std::forward<Args>(args)...);
+            store_relaxed(t->slots + i, &e, sizeof(entry));
+        } else {
+            entry_alloc alloc(alloc_);
+            entry_traits::construct(alloc, t->slots + i, std::forward<Args>(args)...);
+        }
+        t->growth_left -= detail::is_empty(t->ctrl[i]);
+        set_ctrl(t, i, detail::h2(hash));
+        ++t->size;
+    }
+
+    // Copies the live elements of the shard into a fresh table, publishes
+    // it, and retires the old one. Elements are moved only when that cannot
+    // throw, as with std::move_if_noexcept, so if filling the new table
+    // fails the old one is still intact and stays current. Elements that
+    // can be neither copied nor moved without throwing only get the basic
+    // guarantee.
+    void grow(shard& s, std::size_t capacity) {
+        table* old = s.current.load(std::memory_order_relaxed);
+        table* t = allocate_table(capacity);
+        if (old) {
+            entry_alloc alloc(alloc_);
+            try {
+                for (std::size_t j = 0; j != old->capacity; ++j) {
+                    if (!detail::is_full(old->ctrl[j])) continue;
+                    const std::size_t hash = hash_of(old->slots[j].key);
+                    const std::size_t i = find_first_non_full(t, hash);
+                    entry_traits::construct(alloc, t->slots + i, std::move_if_noexcept(old->slots[j]));
+                    set_ctrl(t, i, detail::h2(hash));
+                    ++t->size;
+                }
+            } catch (...) {
+                destroy_table(t);
+                throw;
+            }
+            t->growth_left -= t->size;
+            if constexpr (lock_free_misses) s.retired.reserve(s.retired.size() + 1);
+        }
+        s.current.store(t, std::memory_order_release);
+        if (!old) return;
+        // Optimistic readers may still be probing the old table. Lock-free
+        // readers copy its elements, which are trivially copyable, so
+        // "moving" them left it intact; the others only look at its control
+        // bytes, so the elements can go now. Without such readers nothing
+        // else can be looking at it.
+        if constexpr (lock_free_reads) {
+            s.retired.push_back(old);
+        } else if constexpr (lock_free_misses) {
+            destroy_elements(old);
+            s.retired.push_back(old);
+        } else {
+            destroy_table(old);
+        }
+    }
+
+    // Clears the tombstones of a mostly deleted table. A rebuild at the same
+    // size would retire a table each time, so under steady erase/insert
+    // churn the retired list would grow without bound; with optimistic
+    // readers the table is instead rehashed in place inside a write
+    // section, which readers probing it meanwhile fail to validate. Other
+    // element types keep the rebuild, which frees the old table at once and
+    // (see grow) leaves it untouched if a copy throws.
+    void purge(shard& s, table* t) {
+        if constexpr (lock_free_misses) {
+            write_section w(s);
+            drop_deletes_without_resize(t);
+        } else {
+            grow(s, t->capacity);
+        }
+    }
+
+    // As in raw_hash_table: full slots are marked deleted and revisited,
+    // staying put when already in the right probe group, moving to an empty
+    // target, or swapping with a not yet revisited element. Entries move
+    // without throwing here, so the table is never left half done.
+    void drop_deletes_without_resize(table* t) {
+        for (std::size_t i = 0; i != t->capacity; ++i) {
+            set_ctrl(t, i, detail::is_full(t->ctrl[i]) ? detail::ctrl_deleted : detail::ctrl_empty);
+        }
+        alignas(entry) unsigned char spare_bytes[sizeof(entry)];
+        entry* spare = reinterpret_cast<entry*>(spare_bytes);
+        for (std::size_t i = 0; i != t->capacity; ++i) {
+            if (!detail::is_deleted(t->ctrl[i])) continue;
+            const std::size_t hash = hash_of(t->slots[i].key);
+            const std::size_t j = find_first_non_full(t, hash);
+            const std::size_t home = detail::h1(hash) & t->capacity;
+            const auto probe_group = [&](std::size_t pos) { return ((pos - home) & t->capacity) / group::width; };
+            if (probe_group(i) == probe_group(j)) {
+                set_ctrl(t, i, detail::h2(hash));
+            } else if (detail::is_empty(t->ctrl[j])) {
+                set_ctrl(t, j, detail::h2(hash));
+                transfer(t->slots + j, t->slots + i);
+                set_ctrl(t, i, detail::ctrl_empty);
+            } else {
+                set_ctrl(t, j, detail::h2(hash));
+                transfer(spare, t->slots + i);
+                transfer(t->slots + i, t->slots + j);
+                transfer(t->slots + j, spare);
+                --i;
+            }
+        }
+        t->growth_left = detail::capacity_to_growth(t->capacity) - t->size;
+    }
+
+    // Moves an entry into uninitialised storage and destroys the source.
+    void transfer(entry* dst, entry* src) noexcept {
+        if constexpr (lock_free_reads) {
+            store_relaxed(dst, src, sizeof(entry));
+        } else {
+            entry_alloc alloc(alloc_);
+            entry_traits::construct(alloc, dst, std::move(*src));
+            entry_traits::destroy(alloc, src);
+        }
+    }
+
+    template <class Key>
+    const entry* find_entry(const table* t, const Key& key, std::size_t hash) const {
+        return const_cast<concurrent_super_hashmap*>(this)->find_entry(const_cast<table*>(t), key, hash);
+    }
+
+    template <class Key>
+    entry* find_entry(table* t, const Key& key, std::size_t hash) {
+        if (!t) return nullptr;
+        const ctrl_t tag = detail::h2(hash);
+        for (probe_seq seq(detail::h1(hash), t->capacity);; seq.next()) {
+            const group g(t->ctrl + seq.offset());
+            for (std::uint32_t i : g.match(tag)) {
+                entry* e = t->slots + seq.offset(i);
+                if (eq_(e->key, key)) return e;
+            }
+            if (g.match_empty()) return nullptr;
+        }
+    }
+
+    // Lookup racing with writers; the result is only trusted if the shard's
+    // sequence counter is unchanged afterwards. Every read stays inside the
+    // table t, which is never freed while the map is in use, and the probe
+    // is bounded so that a torn view cannot loop forever. Control bytes,
+    // keys and values are copied out with relaxed atomic loads, so Eq and
+    // the group scan never see bytes that change under them.
+    template <class Key>
+    bool find_optimistic(const table* t, const Key& key, std::size_t hash, unsigned char* value_out) const {
+        if (!t) return false;
+        const ctrl_t tag = detail::h2(hash);
+        for (probe_seq seq(detail::h1(hash), t->capacity); seq.index() <= t->capacity; seq.next()) {
+            ctrl_t ctrl_copy[group::width];
+            load_relaxed(ctrl_copy, t->ctrl + seq.offset(), group::width);
+            const group g(ctrl_copy);
+            for (std::uint32_t i : g.match(tag)) {
+                const entry* e = t->slots + seq.offset(i);
+                alignas(K) unsigned char key_copy[sizeof(K)];
+                load_relaxed(key_copy, &e->key, sizeof(K));
+                if (eq_(*std::launder(reinterpret_cast<const K*>(key_copy)), key)) {
+                    load_relaxed(value_out, &e->value, sizeof(V));
+                    return true;
+                }
+            }
+            if (g.match_empty()) return false;
+        }
+        return false;
+    }
+
+    // The control-byte half of find_optimistic: whether the tag of hash
+    // shows up before the probe sequence reaches an empty slot. Bounded
+    // like find_optimistic, and true when the bound is hit.
+    static bool probe_tag(const table* t, std::size_t hash) noexcept {
+        if (!t) return false;
+        const ctrl_t tag = detail::h2(hash);
+        for (probe_seq seq(detail::h1(hash), t->capacity); seq.index() <= t->capacity; seq.next()) {
+            ctrl_t ctrl_copy[group::width];
+            load_relaxed(ctrl_copy, t->ctrl + seq.offset(), group::width);
+            const group g(ctrl_copy);
+            if (g.match(tag)) return true;
+            if (g.match_empty()) return false;
+        }
+        return true;
+    }
+
+    static std::size_t find_first_non_full(const table* t, std::size_t hash) noexcept {
+        return detail::find_first_non_full(t->ctrl, t->capacity, hash);
+    }
+
+    // Byte-wise relaxed atomic copies, the only way optimistic readers and
+    // the writers racing with them touch a published table (its control
+    // bytes, and with lock-free reads its entries). On common
+    // targets each is a plain byte load or store.
+    static void load_relaxed(void* dst, const void* src, std::size_t n) noexcept {
+        auto* out = static_cast<unsigned char*>(dst);
+        auto* in = static_cast<unsigned char*>(const_cast<void*>(src));
+        for (std::size_t i = 0; i != n; ++i) out[i] = std::atomic_ref(in[i]).load(std::memory_order_relaxed);
+    }
+
+    static void store_relaxed(void* dst, const void* src, std::size_t n) noexcept {
+        auto* out = static_cast<unsigned char*>(dst);
+        const auto* in = static_cast<const unsigned char*>(src);
+        for (std::size_t i = 0; i != n; ++i) std::atomic_ref(out[i]).store(in[i], std::memory_order_relaxed);
+    }
+
+    static void set_ctrl(table* t, std::size_t i, ctrl_t c) noexcept {
+        if constexpr (lock_free_misses) {
+            std::atomic_ref(t->ctrl[i]).store(c, std::memory_order_relaxed);
+            std::atomic_ref(t->ctrl[detail::clone_index(t->capacity, i)]).store(c, std::memory_order_relaxed);
+        } else {
+            detail::set_ctrl(t->ctrl, t->capacity, i, c);
+        }
+    }
+
+    static void reset_ctrl(table* t) noexcept {
+        if constexpr (lock_free_misses) {
+            for (std::size_t i = 0; i != t->capacity + 1 + detail::cloned_bytes; ++i) {
+                std::atomic_ref(t->ctrl[i]).store(detail::ctrl_empty, std::memory_order_relaxed);
+            }
+            std::atomic_ref(t->ctrl[t->capacity]).store(detail::ctrl_sentinel, std::memory_order_relaxed);
+        } else {
+            detail::reset_ctrl(t->ctrl, t->capacity);
+        }
+    }
+
+    // Runs f on an entry's value. With lock-free readers the value is
+    // updated on a copy and stored back, since f writes through a plain V&.
+    template <class F>
+    void update_value(entry* e, F&& f) {
+        if constexpr (lock_free_reads) {
+            V v = e->value;
+            f(v);
+            store_relaxed(&e->value, &v, sizeof(V));
+        } else {
+            f(e->value);
+        }
+    }
+
+    static std::size_t align_up(std::size_t n, std::size_t a) noexcept { return (n + a - 1) & ~(a - 1); }
+    static std::size_t ctrl_offset() noexcept { return align_up(sizeof(table), alignof(entry)); }
+    static std::size_t slot_offset(std::size_t capacity) noexcept {
+        return align_up(ctrl_offset() + capacity + 1 + detail::cloned_bytes, alignof(entry));
+    }
+    static std::size_t alloc_blocks(std::size_t capacity) noexcept {
+        return (slot_offset(capacity) + capacity * sizeof(entry) + sizeof(block) - 1) / sizeof(block);
+    }
+
+    table* allocate_table(std::size_t capacity) {
+        block_alloc alloc(alloc_);
+        auto* mem = reinterpret_cast<unsigned char*>(std::to_address(block_traits::allocate(alloc, alloc_blocks(capacity))));
+        table* t = ::new (mem) table{capacity, 0, detail::capacity_to_growth(capacity),
+                                     reinterpret_cast<ctrl_t*>(mem + ctrl_offset()),
+                                     reinterpret_cast<entry*>(mem + slot_offset(capacity))};
+        reset_ctrl(t);
+        return t;
+    }
+
+    void destroy_elements(table* t) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<entry>) {
+            entry_alloc alloc(alloc_);
+            for (std::size_t j = 0; j != t->capacity; ++j) {
+                if (detail::is_full(t->ctrl[j])) entry_traits::destroy(alloc, t->slots + j);
+            }
+        }
+    }
+
+    void deallocate_table(table* t) noexcept {
+        block_alloc alloc(alloc_);
+        const std::size_t blocks = alloc_blocks(t->capacity);
+        using block_pointer = typename block_traits::pointer;
+        block_traits::deallocate(alloc, std::pointer_traits<block_pointer>::pointer_to(*reinterpret_cast<block*>(t)),
+                                 blocks);
+    }
+
+    void destroy_table(table* t) noexcept {
+        if (!t) return;
+        destroy_elements(t);
+        deallocate_table(t);
+    }
+
+    std::unique_ptr<shard[]> shards_;
+    unsigned shard_bits_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Eq eq_;
+    [[no_unique_address]] Alloc alloc_;
+};
+
+}  // namespace shm
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+namespace shm::detail {
+
+// One control byte per slot. Full slots store the low 7 bits of their hash
+// tag (always non-negative), the remaining states are negative so that
+// "is this slot free" is a sign test.
+using ctrl_t = std::int8_t;
+
+inline constexpr ctrl_t ctrl_empty = -128;   // 0b10000000
+inline constexpr ctrl_t ctrl_deleted = -2;   // 0b11111110
+inline constexpr ctrl_t ctrl_sentinel = -1;  // 0b11111111, marks the end for iterators
+
+constexpr bool is_full(ctrl_t c) noexcept { return c >= 0; }
+constexpr bool is_empty(ctrl_t c) noexcept { return c == ctrl_empty; }
+constexpr bool is_deleted(ctrl_t c) noexcept { return c == ctrl_deleted; }
+constexpr bool is_empty_or_deleted(ctrl_t c) noexcept { return c < ctrl_sentinel; }
+
+// The hash is split in two: h1 picks the home slot, h2 is the 7-bit tag kept
+// in the control byte. h2 comes from the top bits so that it is independent
+// of the low bits h1 is masked down to.
+constexpr std::size_t h1(std::size_t hash) noexcept { return hash; }
+constexpr ctrl_t h2(std::size_t hash) noexcept {
+    return static_cast<ctrl_t>(hash >> (sizeof(std::size_t) * CHAR_BIT - 7));
+}
+
+}  // namespace shm::detail
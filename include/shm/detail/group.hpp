@@ -0,0 +1,257 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "shm/detail/ctrl.hpp"
+
+// The group implementation is picked at compile time from the target ISA:
+// AVX2 scans 32 control bytes per probe, SSE2 16, and the portable fallback
+// 8 bytes in a 64-bit word. Define SHM_NO_AVX2 or SHM_NO_SIMD to force a
+// narrower one. All translation units of a program must agree on the choice.
+#if !defined(SHM_NO_SIMD) && defined(__AVX2__) && !defined(SHM_NO_AVX2)
+#define SHM_GROUP_AVX2 1
+#include <immintrin.h>
+#elif !defined(SHM_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SHM_GROUP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace shm::detail {
+
+// A set of matching positions within a group. Shift is log2 of the number
+// of mask bits per slot: 0 for the movemask based groups, 3 for the
+// portable one, which keeps one flag per byte.
+template <class T, int Width, int Shift = 0>
+class bitmask {
+public:
+    explicit constexpr bitmask(T mask) noexcept : mask_(mask) {}
+
+    constexpr explicit operator bool() const noexcept { return mask_ != 0; }
+
+    constexpr std::uint32_t lowest_bit_set() const noexcept {
+        return static_cast<std::uint32_t>(std::countr_zero(mask_)) >> Shift;
+    }
+
+    // Slots below the lowest set one, and above the highest set one; the
+    // full width for an empty mask.
+    constexpr std::uint32_t trailing_zeros() const noexcept {
+        return static_cast<std::uint32_t>(std::countr_zero(mask_)) >> Shift;
+    }
+    constexpr std::uint32_t leading_zeros() const noexcept {
+        constexpr int unused = std::numeric_limits<T>::digits - (Width << Shift);
+        return static_cast<std::uint32_t>(std::countl_zero(mask_) - unused) >> Shift;
+    }
+
+    constexpr bitmask& operator++() noexcept {
+        mask_ &= mask_ - 1;
+        return *this;
+    }
+
+    constexpr std::uint32_t operator*() const noexcept { return lowest_bit_set(); }
+
+    constexpr bitmask begin() const noexcept { return *this; }
+    constexpr bitmask end() const noexcept { return bitmask(0); }
+
+    friend constexpr bool operator==(const bitmask& a, const bitmask& b) noexcept { return a.mask_ == b.mask_; }
+
+private:
+    T mask_;
+};
+
+#if defined(SHM_GROUP_AVX2)
+
+struct group_avx2 {
+    static constexpr std::size_t width = 32;
+    using mask_type = bitmask<std::uint32_t, 32>;
+
+    explicit group_avx2(const ctrl_t* pos) noexcept
+        : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos))) {}
+
+    mask_type match(ctrl_t tag) const noexcept {
+        return mask_type(movemask(_mm256_cmpeq_epi8(_mm256_set1_epi8(tag), ctrl)));
+    }
+
+    mask_type match_empty() const noexcept {
+        return mask_type(movemask(_mm256_cmpeq_epi8(_mm256_set1_epi8(ctrl_empty), ctrl)));
+    }
+
+    mask_type match_empty_or_deleted() const noexcept {
+        return mask_type(movemask(_mm256_cmpgt_epi8(_mm256_set1_epi8(ctrl_sentinel), ctrl)));
+    }
+
+    std::uint32_t count_leading_empty_or_deleted() const noexcept {
+        return static_cast<std::uint32_t>(
+            std::countr_one(movemask(_mm256_cmpgt_epi8(_mm256_set1_epi8(ctrl_sentinel), ctrl))));
+    }
+
+    static std::uint32_t movemask(__m256i v) noexcept { return static_cast<std::uint32_t>(_mm256_movemask_epi8(v)); }
+
+    __m256i ctrl;
+};
+
+using group = group_avx2;
+
+#elif defined(SHM_GROUP_SSE2)
+
+struct group_sse2 {
+    static constexpr std::size_t width = 16;
+    using mask_type = bitmask<std::uint16_t, 16>;
+
+    explicit group_sse2(const ctrl_t* pos) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+    mask_type match(ctrl_t tag) const noexcept {
+        return mask_type(movemask(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl)));
+    }
+
+    mask_type match_empty() const noexcept {
+        return mask_type(movemask(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl_empty), ctrl)));
+    }
+
+    mask_type match_empty_or_deleted() const noexcept {
+        return mask_type(movemask(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl)));
+    }
+
+    std::uint32_t count_leading_empty_or_deleted() const noexcept {
+        return static_cast<std::uint32_t>(
+            std::countr_one(movemask(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl))));
+    }
+
+    static std::uint16_t movemask(__m128i v) noexcept { return static_cast<std::uint16_t>(_mm_movemask_epi8(v)); }
+
+    __m128i ctrl;
+};
+
+using group = group_sse2;
+
+#else
+
+// SWAR fallback: eight control bytes in a little-endian 64-bit word, one
+// flag in the high bit of each byte. match() may report a false positive
+// right after a true one; callers compare keys anyway.
+struct group_portable {
+    static constexpr std::size_t width = 8;
+    using mask_type = bitmask<std::uint64_t, 8, 3>;
+
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ULL;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ULL;
+
+    // Assembled byte by byte so the layout is the same on either byte
+    // order; compilers fold this into a single load on little-endian.
+    explicit group_portable(const ctrl_t* pos) noexcept : ctrl(0) {
+        for (std::size_t i = 0; i != width; ++i) ctrl |= std::uint64_t{static_cast<std::uint8_t>(pos[i])} << (8 * i);
+    }
+
+    mask_type match(ctrl_t tag) const noexcept {
+        const std::uint64_t x = ctrl ^ (lsbs * static_cast<std::uint8_t>(tag));
+        return mask_type((x - lsbs) & ~x & msbs);
+    }
+
+    mask_type match_empty() const noexcept { return mask_type((ctrl & ~(ctrl << 6)) & msbs); }
+
+    mask_type match_empty_or_deleted() const noexcept { return mask_type((ctrl & ~(ctrl << 7)) & msbs); }
+
+    std::uint32_t count_leading_empty_or_deleted() const noexcept {
+        constexpr std::uint64_t gaps = 0x00FEFEFEFEFEFEFEULL;
+        return static_cast<std::uint32_t>((std::countr_zero(((~ctrl & (ctrl >> 7)) | gaps) + 1) + 7) >> 3);
+    }
+
+    std::uint64_t ctrl;
+};
+
+using group = group_portable;
+
+#endif
+
+// Control bytes past the sentinel mirror the first group_width - 1 bytes so
+// that a group can be loaded at any slot without wrapping.
+inline constexpr std::size_t cloned_bytes = group::width - 1;
+
+// Where the clone of control byte i lives. For i >= cloned_bytes the
+// mirror index is i itself.
+inline std::size_t clone_index(std::size_t capacity, std::size_t i) noexcept {
+    return ((i - cloned_bytes) & capacity) + cloned_bytes;
+}
+
+// Sets a control byte and its clone past the sentinel, if it has one.
+inline void set_ctrl(ctrl_t* ctrl, std::size_t capacity, std::size_t i, ctrl_t c) noexcept {
+    ctrl[i] = c;
+    ctrl[clone_index(capacity, i)] = c;
+}
+
+// Marks every slot empty and places the sentinel.
+inline void reset_ctrl(ctrl_t* ctrl, std::size_t capacity) noexcept {
+    std::memset(ctrl, static_cast<unsigned char>(ctrl_empty), capacity + 1 + cloned_bytes);
+    ctrl[capacity] = ctrl_sentinel;
+}
+
+// First step of an in-place rehash: full slots become deleted (still to be
+// placed) and tombstones become empty. The clones are refreshed through
+// clone_index, which in a table smaller than a group is not
+// capacity + 1 + i.
+inline void convert_deleted_to_empty_and_full_to_deleted(ctrl_t* ctrl, std::size_t capacity) noexcept {
+    for (std::size_t i = 0; i != capacity; ++i) ctrl[i] = is_full(ctrl[i]) ? ctrl_deleted : ctrl_empty;
+    const std::size_t originals = capacity < cloned_bytes ? capacity : cloned_bytes;
+    for (std::size_t i = 0; i != originals; ++i) ctrl[clone_index(capacity, i)] = ctrl[i];
+}
+
+// Triangular probing over groups. Since capacity + 1 is a power of two and a
+// multiple of the group width, the sequence visits every group exactly once.
+class probe_seq {
+public:
+    probe_seq(std::size_t hash, std::size_t mask) noexcept : mask_(mask), offset_(hash & mask) {}
+
+    std::size_t offset() const noexcept { return offset_; }
+    std::size_t offset(std::size_t i) const noexcept { return (offset_ + i) & mask_; }
+    std::size_t index() const noexcept { return index_; }
+
+    void next() noexcept {
+        index_ += group::width;
+        offset_ = (offset_ + index_) & mask_;
+    }
+
+private:
+    std::size_t mask_;
+    std::size_t offset_;
+    std::size_t index_ = 0;
+};
+
+// Hint to pull the cache line holding p in ahead of use.
+inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+// First empty or deleted slot on the probe sequence of hash.
+inline std::size_t find_first_non_full(const ctrl_t* ctrl, std::size_t capacity, std::size_t hash) noexcept {
+    for (probe_seq seq(h1(hash), capacity);; seq.next()) {
+        if (const auto mask = group(ctrl + seq.offset()).match_empty_or_deleted()) {
+            return seq.offset(mask.lowest_bit_set());
+        }
+    }
+}
+
+// Whether slot i, about to be freed, can go back to empty rather than
+// become a tombstone. A lookup only walks past a slot inside a group with
+// no empty slot. If the nearest empty slots before and after i are less
+// than a group apart, every group covering i contains one of them, so no
+// lookup can have passed i and none can depend on it staying occupied.
+// A table smaller than a group is always seen whole by the first probe,
+// which never comes up full since one slot is always left empty.
+inline bool was_never_full(const ctrl_t* ctrl, std::size_t capacity, std::size_t i) noexcept {
+    if (capacity < group::width) return true;
+    const auto empty_after = group(ctrl + i).match_empty();
+    const auto empty_before = group(ctrl + ((i - group::width) & capacity)).match_empty();
+    return empty_before && empty_after && empty_after.trailing_zeros() + empty_before.leading_zeros() < group::width;
+}
+
+}  // namespace shm::detail
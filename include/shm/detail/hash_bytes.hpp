@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "shm/detail/mix.hpp"
+
+namespace shm::detail {
+
+// Byte-string hash in the style of wyhash: 16 bytes per multiply for
+// medium inputs, three independent lanes for long ones, and a seed folded
+// in up front so that colliding inputs cannot be precomputed without it.
+
+inline constexpr std::uint64_t hash_secret[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+                                                  0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+inline std::uint64_t read64(const unsigned char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t read32(const unsigned char* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 1 to 3 bytes: first, middle and last byte.
+inline std::uint64_t read_small(const unsigned char* p, std::size_t n) noexcept {
+    return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[n >> 1]} << 8) | p[n - 1];
+}
+
+inline std::uint64_t hash_bytes(const void* data, std::size_t len, std::uint64_t seed) noexcept {
+    const auto* p = static_cast<const unsigned char*>(data);
+    seed ^= mulx64(seed ^ hash_secret[0], hash_secret[1]);
+    std::uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            const std::size_t mid = (len >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + mid);
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = read_small(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        std::size_t i = len;
+        if (i > 48) {
+            std::uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = mulx64(read64(p) ^ hash_secret[1], read64(p + 8) ^ seed);
+                lane1 = mulx64(read64(p + 16) ^ hash_secret[2], read64(p + 24) ^ lane1);
+                lane2 = mulx64(read64(p + 32) ^ hash_secret[3], read64(p + 40) ^ lane2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (i > 16) {
+            seed = mulx64(read64(p) ^ hash_secret[1], read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // The last 16 bytes, overlapping already hashed ones if need be.
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    mul128(a ^ hash_secret[1], b ^ seed, a, b);
+    return mulx64(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]);
+}
+
+}  // namespace shm::detail
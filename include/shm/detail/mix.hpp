@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace shm::detail {
+
+// Full 64x64 -> 128 bit product as (low, high) halves.
+inline void mul128(std::uint64_t a, std::uint64_t b, std::uint64_t& lo, std::uint64_t& hi) noexcept {
+#if defined(__SIZEOF_INT128__)
+    // __extension__ keeps -Wpedantic quiet about the non-standard type.
+    __extension__ using uint128 = unsigned __int128;
+    const uint128 r = static_cast<uint128>(a) * b;
+    lo = static_cast<std::uint64_t>(r);
+    hi = static_cast<std::uint64_t>(r >> 64);
+#else
+    const std::uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    const std::uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    const std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+    hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    lo = (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+#endif
+}
+
+// 64x64 -> 128 bit multiply folded back to 64 bits by xoring the halves.
+inline std::uint64_t mulx64(std::uint64_t a, std::uint64_t b) noexcept {
+    std::uint64_t lo, hi;
+    mul128(a, b, lo, hi);
+    return lo ^ hi;
+}
+
+// Spreads the entropy of a possibly weak hash (e.g. the identity hash of
+// std::hash<int>) over all bits, so both the high and low bits can be used.
+inline std::size_t mix(std::size_t hash) noexcept {
+    return static_cast<std::size_t>(mulx64(hash, 0x9E3779B97F4A7C15ULL));
+}
+
+// A hasher declares `using is_avalanching = void;` when every output bit
+// already depends on every input bit; the tables then use its result as is.
+template <class Hash, class = void>
+struct is_avalanching : std::false_type {};
+template <class Hash>
+struct is_avalanching<Hash, std::void_t<typename Hash::is_avalanching>> : std::true_type {};
+
+// The hash every table works with: the hasher's result, mixed unless the
+// hasher vouches for its own quality. Tables use both the low bits (probe
+// position) and the top seven (control byte tag).
+template <class Hash, class K>
+std::size_t hash_value(const Hash& hash, const K& key) {
+    if constexpr (is_avalanching<Hash>::value) {
+        return static_cast<std::size_t>(hash(key));
+    } else {
+        return mix(static_cast<std::size_t>(hash(key)));
+    }
+}
+
+}  // namespace shm::detail
@@ -0,0 +1,1172 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "shm/detail/ctrl.hpp"
+#include "shm/detail/group.hpp"
+#include "shm/detail/mix.hpp"
+#include "shm/parallel.hpp"
+#include "shm/stats.hpp"
+
+namespace shm::detail {
+
+// Capacities are always of the form 2^k - 1 so that the capacity doubles as
+// the probe mask. The smallest table is one group, which keeps the cloned
+// control bytes from wrapping more than once.
+inline constexpr std::size_t min_capacity = group::width - 1;
+
+constexpr std::size_t normalize_capacity(std::size_t n) noexcept {
+    return n <= min_capacity ? min_capacity : ~std::size_t{} >> std::countl_zero(n);
+}
+
+// Maximum load factor is 7/8; at least one slot is always left empty so that
+// every probe sequence terminates.
+constexpr std::size_t capacity_to_growth(std::size_t capacity) noexcept {
+    return capacity - (capacity + 1) / 8;
+}
+
+constexpr std::size_t growth_to_capacity(std::size_t growth) noexcept {
+    std::size_t capacity = normalize_capacity(growth + growth / 7);
+    while (capacity_to_growth(capacity) < growth) capacity = capacity * 2 + 1;
+    return capacity;
+}
+
+template <class T, class = void>
+struct is_transparent : std::false_type {};
+template <class T>
+struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+// Lookup functions take key_arg<K>: when both the hasher and the equality
+// are transparent it is K itself, deduced from the argument, so a
+// std::string_view can be looked up in a table of std::string without a
+// temporary. Otherwise it is the key type and K is not deduced.
+template <bool Transparent>
+struct key_arg_impl {
+    template <class K, class Key>
+    using type = Key;
+};
+template <>
+struct key_arg_impl<true> {
+    template <class K, class Key>
+    using type = K;
+};
+
+template <class Alloc>
+struct is_polymorphic_allocator : std::false_type {};
+template <class T>
+struct is_polymorphic_allocator<std::pmr::polymorphic_allocator<T>> : std::true_type {};
+
+// Destroying a T through Alloc does nothing: T has a trivial destructor and
+// Alloc either has no destroy() or, like polymorphic_allocator, only calls
+// the destructor from it. Tearing down such a table skips the walk over the
+// control bytes and just releases the storage.
+template <class Alloc, class T>
+inline constexpr bool trivially_destroyed =
+    std::is_trivially_destructible_v<T> &&
+    (is_polymorphic_allocator<Alloc>::value || !requires(Alloc& a, T* p) { a.destroy(p); });
+
+template <class Hash, class Eq, class K, class Key>
+using key_arg = typename key_arg_impl<is_transparent<Hash>::value && is_transparent<Eq>::value>::template type<K, Key>;
+
+// Open-addressing table shared by the map and set front ends. Elements live
+// in one flat slot array, with a parallel array of control bytes in front of
+// it; both come from a single allocation. Lookups scan a whole group of
+// control bytes at a time for the 7-bit tag of the key, so slots are only
+// touched for tag matches.
+//
+// Policy describes the element:
+//   key_type, value_type, slot_type
+//   static const key_type& key(const slot_type&)
+//   static value_type& element(slot_type*)
+//   static void transfer(Alloc&, slot_type* dst, slot_type* src)
+//   static bool key_extractable<Args...> / extract_key(args...) for emplace
+template <class Policy, class Hash, class Eq, class Alloc>
+class raw_hash_table {
+    using policy = Policy;
+    using slot_type = typename Policy::slot_type;
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    static constexpr std::size_t slot_align = std::max(alignof(slot_type), alignof(std::max_align_t));
+    struct alignas(slot_align) block {
+        unsigned char bytes[slot_align];
+    };
+    using block_alloc = typename alloc_traits::template rebind_alloc<block>;
+    using block_traits = std::allocator_traits<block_alloc>;
+
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename alloc_traits::pointer;
+    using const_pointer = typename alloc_traits::const_pointer;
+
+    static_assert(std::is_same_v<typename alloc_traits::value_type, value_type>,
+                  "allocator_type::value_type must be value_type");
+
+protected:
+    template <class K>
+    using key_arg = detail::key_arg<Hash, Eq, K, key_type>;
+
+private:
+    // Old slot array being drained into the current one by an incremental
+    // resize. Slots before cursor have been moved (or were never full).
+    struct migration {
+        ctrl_t* ctrl;
+        slot_type* slots;
+        std::size_t capacity;
+        std::size_t cursor;
+    };
+    using migration_alloc = typename alloc_traits::template rebind_alloc<migration>;
+    using migration_traits = std::allocator_traits<migration_alloc>;
+
+    template <bool Const>
+    class iter {
+        friend class raw_hash_table;
+
+        ctrl_t* ctrl_ = nullptr;
+        slot_type* slot_ = nullptr;
+        const raw_hash_table* owner_ = nullptr;
+
+        iter(ctrl_t* ctrl, slot_type* slot, const raw_hash_table* owner) noexcept
+            : ctrl_(ctrl), slot_(slot), owner_(owner) {}
+
+        void skip_empty_or_deleted() noexcept {
+            for (;;) {
+                while (is_empty_or_deleted(*ctrl_)) {
+                    const std::uint32_t shift = group(ctrl_).count_leading_empty_or_deleted();
+                    ctrl_ += shift;
+                    slot_ += shift;
+                }
+                // Stopped at an element or a sentinel. During an incremental
+                // resize the old array is visited first and its sentinel
+                // continues into the current array.
+                if (*ctrl_ != ctrl_sentinel) return;
+                const migration* m = owner_->migration_;
+                if (!m || ctrl_ != m->ctrl + m->capacity) return;
+                ctrl_ = owner_->ctrl_;
+                slot_ = owner_->slots_;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename raw_hash_table::value_type;
+        using difference_type = std::ptrdiff_t;
+        // Sets hand out const elements even through iterator, since
+        // changing a key in place would corrupt the table.
+        using reference = std::conditional_t<Const || policy::constant_iterators, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const || policy::constant_iterators, const value_type*, value_type*>;
+
+        iter() noexcept = default;
+
+        template <bool C = Const, std::enable_if_t<C, int> = 0>
+        iter(const iter<false>& other) noexcept : ctrl_(other.ctrl_), slot_(other.slot_), owner_(other.owner_) {}
+
+        reference operator*() const noexcept { return policy::element(slot_); }
+        pointer operator->() const noexcept { return std::addressof(**this); }
+
+        iter& operator++() noexcept {
+            ++ctrl_;
+            ++slot_;
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        iter operator++(int) noexcept {
+            iter tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iter& a, const iter& b) noexcept { return a.ctrl_ == b.ctrl_; }
+    };
+
+public:
+    using iterator = iter<false>;
+    using const_iterator = iter<true>;
+
+    raw_hash_table() noexcept(std::is_nothrow_default_constructible_v<Hash> &&
+                              std::is_nothrow_default_constructible_v<Eq> &&
+                              std::is_nothrow_default_constructible_v<Alloc>) = default;
+
+    explicit raw_hash_table(size_type bucket_count, const Hash& hash = Hash(), const Eq& eq = Eq(),
+                            const Alloc& alloc = Alloc())
+        : hash_(hash), eq_(eq), alloc_(alloc) {
+        if (bucket_count) initialize_slots(normalize_capacity(bucket_count));
+    }
+
+    raw_hash_table(size_type bucket_count, const Alloc& alloc)
+        : raw_hash_table(bucket_count, Hash(), Eq(), alloc) {}
+
+    raw_hash_table(size_type bucket_count, const Hash& hash, const Alloc& alloc)
+        : raw_hash_table(bucket_count, hash, Eq(), alloc) {}
+
+    explicit raw_hash_table(const Alloc& alloc) : alloc_(alloc) {}
+
+    template <class InputIt>
+    raw_hash_table(InputIt first, InputIt last, size_type bucket_count = 0, const Hash& hash = Hash(),
+                   const Eq& eq = Eq(), const Alloc& alloc = Alloc())
+        : raw_hash_table(bucket_count, hash, eq, alloc) {
+        guarded([&] { insert(first, last); });
+    }
+
+    template <class InputIt>
+    raw_hash_table(InputIt first, InputIt last, size_type bucket_count, const Alloc& alloc)
+        : raw_hash_table(first, last, bucket_count, Hash(), Eq(), alloc) {}
+
+    template <class InputIt>
+    raw_hash_table(InputIt first, InputIt last, size_type bucket_count, const Hash& hash, const Alloc& alloc)
+        : raw_hash_table(first, last, bucket_count, hash, Eq(), alloc) {}
+
+    raw_hash_table(std::initializer_list<value_type> init, size_type bucket_count = 0, const Hash& hash = Hash(),
+                   const Eq& eq = Eq(), const Alloc& alloc = Alloc())
+        : raw_hash_table(init.begin(), init.end(), bucket_count, hash, eq, alloc) {}
+
+    raw_hash_table(std::initializer_list<value_type> init, size_type bucket_count, const Alloc& alloc)
+        : raw_hash_table(init, bucket_count, Hash(), Eq(), alloc) {}
+
+    raw_hash_table(std::initializer_list<value_type> init, size_type bucket_count, const Hash& hash,
+                   const Alloc& alloc)
+        : raw_hash_table(init, bucket_count, hash, Eq(), alloc) {}
+
+    // Builds the table from a random-access range of elements (or, for a
+    // map, of key/value pairs) on up to threads threads, 0 meaning one per
+    // hardware thread. The keys are hashed in parallel and partitioned by
+    // the top bits of their home slot, which cuts the slot array into
+    // contiguous regions; each region is then filled by one thread, and the
+    // few elements whose probe sequence leaves their region are inserted
+    // afterwards by the calling thread. As with insert(first, last), the
+    // first of several equal keys is kept.
+    //
+    // Takes two words of scratch memory per element while building. The
+    // hasher and equality are called concurrently, and so is the
+    // allocator's construct(): with a memory resource that is not
+    // thread-safe (shm::arena, std::pmr::monotonic_buffer_resource) pass
+    // threads = 1.
+    template <std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R>
+    raw_hash_table(parallel_build_t, const R& range, unsigned threads = 0, const Hash& hash = Hash(),
+                   const Eq& eq = Eq(), const Alloc& alloc = Alloc())
+        : hash_(hash), eq_(eq), alloc_(alloc) {
+        guarded([&] { build_parallel(range, parallel_threads(threads)); });
+    }
+
+    template <std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R>
+    raw_hash_table(parallel_build_t, const R& range, unsigned threads, const Alloc& alloc)
+        : raw_hash_table(parallel_build, range, threads, Hash(), Eq(), alloc) {}
+
+    raw_hash_table(const raw_hash_table& other)
+        : raw_hash_table(other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
+
+    raw_hash_table(const raw_hash_table& other, const Alloc& alloc)
+        : rehash_step_(other.rehash_step_), hash_(other.hash_), eq_(other.eq_), alloc_(alloc) {
+        guarded([&] {
+            reserve(other.size_);
+            for (const auto& v : other) emplace_unique_unchecked(hash_of(policy::key(v)), v);
+        });
+    }
+
+    raw_hash_table(raw_hash_table&& other) noexcept
+        : hash_(std::move(other.hash_)), eq_(std::move(other.eq_)), alloc_(std::move(other.alloc_)) {
+        take_storage(other);
+    }
+
+    raw_hash_table(raw_hash_table&& other, const Alloc& alloc)
+        : rehash_step_(other.rehash_step_), hash_(std::move(other.hash_)), eq_(std::move(other.eq_)), alloc_(alloc) {
+        if (alloc_ == other.alloc_) {
+            take_storage(other);
+        } else {
+            guarded([&] { move_elements_from(other); });
+        }
+    }
+
+    ~raw_hash_table() { destroy_and_deallocate(); }
+
+    raw_hash_table& operator=(const raw_hash_table& other) {
+        if (this != &other) {
+            constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+            raw_hash_table tmp(other, propagate ? other.alloc_ : alloc_);
+            swap_all(tmp);
+        }
+        return *this;
+    }
+
+    raw_hash_table& operator=(raw_hash_table&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+        if (this == &other) return *this;
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            raw_hash_table tmp(std::move(other));
+            swap_all(tmp);
+        } else {
+            destroy_and_deallocate();
+            reset_storage();
+            rehash_step_ = other.rehash_step_;
+            hash_ = std::move(other.hash_);
+            eq_ = std::move(other.eq_);
+            if (alloc_ == other.alloc_) {
+                take_storage(other);
+            } else {
+                move_elements_from(other);
+            }
+        }
+        return *this;
+    }
+
+    raw_hash_table& operator=(std::initializer_list<value_type> init) {
+        clear();
+        insert(init);
+        return *this;
+    }
+
+    iterator begin() noexcept {
+        if (size_ == 0) return end();
+        iterator it = migration_ ? iterator(migration_->ctrl + migration_->cursor, migration_->slots + migration_->cursor, this)
+                                 : iterator(ctrl_, slots_, this);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    iterator end() noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_, this); }
+    const_iterator begin() const noexcept { return const_cast<raw_hash_table*>(this)->begin(); }
+    const_iterator end() const noexcept { return const_cast<raw_hash_table*>(this)->end(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept {
+        return std::min<size_type>(std::numeric_limits<difference_type>::max(),
+                                   block_traits::max_size(block_alloc(alloc_)) * sizeof(block) / (sizeof(slot_type) + 1));
+    }
+
+    void clear() noexcept {
+        destroy_migration();
+        if (capacity_ == 0) return;
+        destroy_slots();
+        reset_ctrl();
+        size_ = 0;
+        growth_left_ = capacity_to_growth(capacity_);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+    std::pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value)); }
+
+    template <class P, std::enable_if_t<std::is_constructible_v<value_type, P&&>, int> = 0>
+    std::pair<iterator, bool> insert(P&& value) {
+        return emplace(std::forward<P>(value));
+    }
+
+    iterator insert(const_iterator, const value_type& value) { return insert(value).first; }
+    iterator insert(const_iterator, value_type&& value) { return insert(std::move(value)).first; }
+
+    template <class P, std::enable_if_t<std::is_constructible_v<value_type, P&&>, int> = 0>
+    iterator insert(const_iterator, P&& value) {
+        return emplace(std::forward<P>(value)).first;
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<InputIt>::iterator_category>) {
+            reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) emplace(*first);
+    }
+
+    void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        if constexpr (policy::template key_extractable<Args...>) {
+            const auto& key = policy::extract_key(args...);
+            return emplace_with_key(key, std::forward<Args>(args)...);
+        } else {
+            // The key is not visible among the arguments; build the element
+            // aside and move it in only if the key turns out to be new.
+            alignas(slot_type) unsigned char raw[sizeof(slot_type)];
+            auto* tmp = reinterpret_cast<slot_type*>(raw);
+            alloc_traits::construct(alloc_, tmp, std::forward<Args>(args)...);
+            std::size_t hash;
+            std::size_t i = npos;
+            iterator it;
+            try {
+                hash = hash_of(policy::key(*tmp));
+                it = find_iter(policy::key(*tmp), hash);
+                if (it == end()) i = prepare_insert(hash);
+            } catch (...) {
+                alloc_traits::destroy(alloc_, tmp);
+                throw;
+            }
+            if (i == npos) {
+                alloc_traits::destroy(alloc_, tmp);
+                return {it, false};
+            }
+            policy::transfer(alloc_, slots_ + i, tmp);
+            commit_insert(i, hash);
+            return {iterator_at(i), true};
+        }
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    iterator erase(const_iterator pos) {
+        iterator next(pos.ctrl_, pos.slot_, this);
+        ++next;
+        erase_element(pos);
+        return next;
+    }
+
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) first = erase(first);
+        return iterator(last.ctrl_, last.slot_, this);
+    }
+
+    template <class K = key_type>
+    size_type erase(const key_arg<K>& key) {
+        const iterator it = find_iter(key, hash_of(key));
+        if (it == end()) return 0;
+        erase_element(it);
+        if (migration_) [[unlikely]]
+            migrate(rehash_step_);
+        return 1;
+    }
+
+    void swap(raw_hash_table& other) noexcept(std::is_nothrow_swappable_v<Hash> && std::is_nothrow_swappable_v<Eq>) {
+        using std::swap;
+        if constexpr (alloc_traits::propagate_on_container_swap::value) swap(alloc_, other.alloc_);
+        swap_storage(other);
+    }
+
+    friend void swap(raw_hash_table& a, raw_hash_table& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+    template <class K = key_type>
+    iterator find(const key_arg<K>& key) {
+        return find_iter(key, hash_of(key));
+    }
+
+    template <class K = key_type>
+    const_iterator find(const key_arg<K>& key) const {
+        return const_cast<raw_hash_table*>(this)->template find<K>(key);
+    }
+
+    template <class K = key_type>
+    bool contains(const key_arg<K>& key) const {
+        return find<K>(key) != end();
+    }
+
+    // Looks up every key at once: out[i] = find(keys[i]). Keys are taken in
+    // windows whose hashes are computed and whose first probe group is
+    // prefetched before any of them is probed, so on a table larger than
+    // the cache the misses overlap instead of being paid one after another.
+    // out must be at least as long as keys. With a transparent hasher, name
+    // the key type to pass other spans: find_batch<std::string_view>(...).
+    template <class K = key_type>
+    void find_batch(std::span<const std::type_identity_t<key_arg<K>>> keys, std::span<iterator> out) {
+        batch_lookup(keys, [&](std::size_t i, iterator it) { out[i] = it; });
+    }
+
+    template <class K = key_type>
+    void find_batch(std::span<const std::type_identity_t<key_arg<K>>> keys, std::span<const_iterator> out) const {
+        const_cast<raw_hash_table*>(this)->batch_lookup(keys, [&](std::size_t i, iterator it) { out[i] = it; });
+    }
+
+    // out[i] = contains(keys[i]); returns how many keys were found.
+    template <class K = key_type>
+    size_type contains_batch(std::span<const std::type_identity_t<key_arg<K>>> keys, std::span<bool> out) const {
+        auto* self = const_cast<raw_hash_table*>(this);
+        const iterator last = self->end();
+        size_type found = 0;
+        self->batch_lookup(keys, [&](std::size_t i, iterator it) {
+            out[i] = it != last;
+            found += out[i];
+        });
+        return found;
+    }
+
+    template <class K = key_type>
+    size_type count(const key_arg<K>& key) const {
+        return contains<K>(key) ? 1 : 0;
+    }
+
+    template <class K = key_type>
+    std::pair<iterator, iterator> equal_range(const key_arg<K>& key) {
+        iterator it = find<K>(key);
+        if (it == end()) return {it, it};
+        iterator next = it;
+        return {it, ++next};
+    }
+
+    template <class K = key_type>
+    std::pair<const_iterator, const_iterator> equal_range(const key_arg<K>& key) const {
+        return const_cast<raw_hash_table*>(this)->template equal_range<K>(key);
+    }
+
+    // Calls f on every element from up to threads threads at once (0: one
+    // per hardware thread), in no particular order. The slot array is cut
+    // into chunks of at least parallel_min_chunk slots, handed to the
+    // threads as they become free; neighbouring chunks may share a cache
+    // line at their boundary, which is rare enough at that size not to
+    // matter. f must be safe to call concurrently and must not insert or
+    // erase. If it throws, chunks not yet started are skipped and the first
+    // exception is rethrown once all threads have stopped.
+    template <class F>
+    void parallel_for_each(F f, unsigned threads = 0) {
+        for_each_parallel<typename iterator::reference>(f, threads);
+    }
+
+    template <class F>
+    void parallel_for_each(F f, unsigned threads = 0) const {
+        for_each_parallel<typename const_iterator::reference>(f, threads);
+    }
+
+    size_type bucket_count() const noexcept { return capacity_; }
+    float load_factor() const noexcept {
+        return capacity_ ? static_cast<float>(size_) / static_cast<float>(capacity_) : 0.0f;
+    }
+    // The maximum load factor is fixed at 7/8; the setter exists only for
+    // source compatibility with std::unordered_map.
+    float max_load_factor() const noexcept { return 7.0f / 8.0f; }
+    void max_load_factor(float) noexcept {}
+
+    // Load, tombstones and displacement, from a scan of the control bytes
+    // and a rehash of every element: O(capacity), meant for diagnostics.
+    // The probe and rehash counters are filled in with SHM_ENABLE_STATS.
+    table_stats stats() const {
+        table_stats s;
+        s.size = size_;
+        s.capacity = capacity_;
+        s.load_factor = load_factor();
+        std::size_t total = 0;
+        scan_stats(ctrl_, slots_, capacity_, s, total);
+        if (migration_) scan_stats(migration_->ctrl, migration_->slots, migration_->capacity, s, total);
+        s.mean_displacement = size_ ? static_cast<double>(total) / static_cast<double>(size_) : 0.0;
+        counters_.copy_to(s);
+        return s;
+    }
+
+    std::string debug_stats() const { return to_string(stats()); }
+
+    // Bytes of table storage held from the allocator: control bytes and
+    // slots, plus the old array while an incremental resize is pending.
+    // Memory that elements own themselves is not counted.
+    size_type memory_usage() const noexcept {
+        size_type bytes = capacity_ ? alloc_blocks(capacity_) * sizeof(block) : 0;
+        if (migration_) bytes += alloc_blocks(migration_->capacity) * sizeof(block) + sizeof(migration);
+        return bytes;
+    }
+
+    // rehash(0) shrinks the table to the smallest capacity that holds size().
+    void rehash(size_type bucket_count) {
+        if (bucket_count == 0 && size_ == 0) {
+            destroy_and_deallocate();
+            reset_storage();
+            return;
+        }
+        const std::size_t wanted = std::max(normalize_capacity(bucket_count), growth_to_capacity(size_));
+        if (bucket_count == 0 || wanted > capacity_) resize(wanted);
+    }
+
+    void reserve(size_type count) {
+        if (count > size_ + growth_left_) resize(growth_to_capacity(count));
+    }
+
+    // Incremental resizing, off by default. With a non-zero step, growing a
+    // table allocates the new slot array up front and then moves step old
+    // slots into it on each later insertion or erase-by-key; lookups check
+    // both arrays until the old one is drained. This bounds the pause of a
+    // single operation at the cost of a second array being live for a
+    // while. Tables of at most 4 * step slots still resize at once.
+    //
+    // While a resize is in progress, erase(key) may move elements and so
+    // invalidates iterators like an insertion does; erase(iterator) never
+    // moves anything.
+    void set_incremental_resize(size_type slots_per_op) noexcept { rehash_step_ = slots_per_op; }
+    size_type incremental_resize() const noexcept { return rehash_step_; }
+    bool resizing() const noexcept { return migration_ != nullptr; }
+
+    // Completes an in-progress incremental resize.
+    void finish_resize() {
+        if (migration_) migrate(npos);
+    }
+
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    friend bool operator==(const raw_hash_table& a, const raw_hash_table& b) {
+        if (a.size_ != b.size_) return false;
+        const raw_hash_table* outer = &a;
+        const raw_hash_table* inner = &b;
+        if (outer->capacity_ > inner->capacity_) std::swap(outer, inner);
+        for (const value_type& v : *outer) {
+            auto it = inner->find(policy::key(v));
+            if (it == inner->end() || !(*it == v)) return false;
+        }
+        return true;
+    }
+
+protected:
+    static constexpr std::size_t npos = ~std::size_t{};
+
+    template <class K>
+    std::size_t hash_of(const K& key) const {
+        return detail::hash_value(hash_, key);
+    }
+
+    template <class K>
+    std::size_t find_in(const ctrl_t* ctrl, const slot_type* slots, std::size_t capacity, const K& key,
+                        std::size_t hash) const {
+        if (capacity == 0) return npos;
+        const ctrl_t tag = h2(hash);
+        for (probe_seq seq(h1(hash), capacity);; seq.next()) {
+            const group g(ctrl + seq.offset());
+            for (std::uint32_t i : g.match(tag)) {
+                const std::size_t idx = seq.offset(i);
+                if (eq_(policy::key(slots[idx]), key)) [[likely]] {
+                    counters_.record_probe(true, seq.index() / group::width + 1);
+                    return idx;
+                }
+            }
+            // A miss is usually decided here, from the control bytes alone.
+            if (g.match_empty()) [[likely]] {
+                counters_.record_probe(false, seq.index() / group::width + 1);
+                return npos;
+            }
+        }
+    }
+
+    template <class K>
+    iterator find_iter(const K& key, std::size_t hash) {
+        std::size_t i = find_in(ctrl_, slots_, capacity_, key, hash);
+        if (i != npos) [[likely]]
+            return iterator_at(i);
+        if (migration_) [[unlikely]] {
+            const migration& m = *migration_;
+            i = find_in(m.ctrl, m.slots, m.capacity, key, hash);
+            if (i != npos) return iterator(m.ctrl + i, m.slots + i, this);
+        }
+        return end();
+    }
+
+    void scan_stats(const ctrl_t* ctrl, const slot_type* slots, std::size_t capacity, table_stats& s,
+                    std::size_t& total) const {
+        for (std::size_t i = 0; i != capacity; ++i) {
+            if (is_deleted(ctrl[i])) ++s.tombstones;
+            if (!is_full(ctrl[i])) continue;
+            std::size_t d = 0;
+            for (probe_seq seq(h1(hash_of(policy::key(slots[i]))), capacity);
+                 ((i - seq.offset()) & capacity) >= group::width; seq.next()) {
+                ++d;
+            }
+            s.max_displacement = std::max(s.max_displacement, d);
+            total += d;
+        }
+    }
+
+    static constexpr std::size_t batch_window = 64;
+
+    template <class K, class Sink>
+    void batch_lookup(std::span<const K> keys, Sink&& sink) {
+        std::size_t hashes[batch_window];
+        for (std::size_t base = 0; base < keys.size(); base += batch_window) {
+            const std::size_t n = std::min(batch_window, keys.size() - base);
+            for (std::size_t j = 0; j != n; ++j) {
+                hashes[j] = hash_of(keys[base + j]);
+                const std::size_t offset = h1(hashes[j]) & capacity_;
+                prefetch(ctrl_ + offset);
+                prefetch(slots_ + offset);
+            }
+            for (std::size_t j = 0; j != n; ++j) sink(base + j, find_iter(keys[base + j], hashes[j]));
+        }
+    }
+
+    template <class K, class... Args>
+    std::pair<iterator, bool> emplace_with_key(const K& key, Args&&... args) {
+        const std::size_t hash = hash_of(key);
+        const iterator it = find_iter(key, hash);
+        if (it != end()) return {it, false};
+        const std::size_t i = prepare_insert(hash);
+        alloc_traits::construct(alloc_, slots_ + i, std::forward<Args>(args)...);
+        commit_insert(i, hash);
+        return {iterator_at(i), true};
+    }
+
+    iterator iterator_at(std::size_t i) noexcept { return iterator(ctrl_ + i, slots_ + i, this); }
+
+private:
+    std::size_t find_first_non_full(std::size_t hash) const noexcept {
+        return detail::find_first_non_full(ctrl_, capacity_, hash);
+    }
+
+    // Returns the slot a new element with this hash should be constructed
+    // in, growing the table first if needed. Nothing is marked as used
+    // until commit_insert, so a throwing constructor leaves the table intact.
+    std::size_t prepare_insert(std::size_t hash) {
+        if (migration_) [[unlikely]]
+            migrate(rehash_step_);
+        if (capacity_ != 0) {
+            const std::size_t i = find_first_non_full(hash);
+            if (is_deleted(ctrl_[i])) return i;
+            if (growth_left_ != 0 && !too_many_tombstones()) [[likely]]
+                return i;
+        }
+        rehash_and_grow_if_necessary();
+        return find_first_non_full(hash);
+    }
+
+    // Tombstones lengthen every probe that reaches them, and under steady
+    // erase/insert churn they would otherwise build up until the growth
+    // budget runs out. Past an eighth of the capacity they are purged
+    // (rehash_and_grow_if_necessary sees a mostly empty table), so lookup
+    // cost stays flat however long the churn goes on. The count follows
+    // from the growth budget, which both elements and tombstones use up;
+    // during an incremental resize it is not kept, and not needed.
+    bool too_many_tombstones() const noexcept {
+        return !migration_ && capacity_to_growth(capacity_) - size_ - growth_left_ > capacity_ / tombstone_ratio;
+    }
+
+    void commit_insert(std::size_t i, std::size_t hash) noexcept {
+        growth_left_ -= is_empty(ctrl_[i]);
+        set_ctrl(i, h2(hash));
+        ++size_;
+    }
+
+    template <class... Args>
+    void emplace_unique_unchecked(std::size_t hash, Args&&... args) {
+        const std::size_t i = prepare_insert(hash);
+        alloc_traits::construct(alloc_, slots_ + i, std::forward<Args>(args)...);
+        commit_insert(i, hash);
+    }
+
+    // Leaves a tombstone only where a lookup may have probed past the slot;
+    // otherwise the slot becomes empty and counts towards growth again.
+    void erase_at(std::size_t i) noexcept {
+        alloc_traits::destroy(alloc_, slots_ + i);
+        --size_;
+        if (was_never_full(ctrl_, capacity_, i)) {
+            set_ctrl(i, ctrl_empty);
+            ++growth_left_;
+        } else {
+            set_ctrl(i, ctrl_deleted);
+        }
+    }
+
+    void erase_element(const_iterator pos) noexcept {
+        if (migration_) [[unlikely]] {
+            const migration& m = *migration_;
+            if (pos.ctrl_ >= m.ctrl && pos.ctrl_ < m.ctrl + m.capacity) {
+                alloc_traits::destroy(alloc_, pos.slot_);
+                detail::set_ctrl(m.ctrl, m.capacity, static_cast<std::size_t>(pos.ctrl_ - m.ctrl), ctrl_deleted);
+                --size_;
+                return;
+            }
+        }
+        erase_at(static_cast<std::size_t>(pos.slot_ - slots_));
+    }
+
+    void rehash_and_grow_if_necessary() {
+        if (capacity_ == 0) {
+            resize(min_capacity);
+            return;
+        }
+        // The new array filled up before the old one was drained.
+        if (migration_) migrate(npos);
+        // Mostly tombstones: clearing them out at the same size is enough.
+        // That is done in place, except with incremental resizing, where a
+        // migration to a fresh array keeps the pause bounded.
+        const bool purge = size_ * 32 <= capacity_ * 25;
+        const std::size_t new_capacity = purge ? capacity_ : capacity_ * 2 + 1;
+        if (rehash_step_ != 0 && capacity_ > 4 * rehash_step_) {
+            start_migration(new_capacity);
+        } else if (purge) {
+            drop_deletes_without_resize();
+        } else {
+            resize(new_capacity);
+        }
+    }
+
+    // Rehashes in place, turning every tombstone back into an empty slot.
+    // All full slots are first marked deleted and all tombstones empty;
+    // then each formerly full slot is revisited. An element whose new
+    // position is in the same probe group stays put, one whose target is
+    // empty moves there, and one whose target holds an element not yet
+    // revisited swaps with it, and the slot is looked at again.
+    void drop_deletes_without_resize() {
+        typename table_counters::rehash_timer timer(counters_);
+        convert_deleted_to_empty_and_full_to_deleted(ctrl_, capacity_);
+        alignas(slot_type) unsigned char tmp[sizeof(slot_type)];
+        slot_type* spare = reinterpret_cast<slot_type*>(tmp);
+        for (std::size_t i = 0; i != capacity_; ++i) {
+            if (!is_deleted(ctrl_[i])) continue;
+            const std::size_t hash = hash_of(policy::key(slots_[i]));
+            const std::size_t j = find_first_non_full(hash);
+            const std::size_t home = h1(hash) & capacity_;
+            const auto probe_group = [&](std::size_t pos) { return ((pos - home) & capacity_) / group::width; };
+            if (probe_group(i) == probe_group(j)) {
+                set_ctrl(i, h2(hash));
+            } else if (is_empty(ctrl_[j])) {
+                set_ctrl(j, h2(hash));
+                policy::transfer(alloc_, slots_ + j, slots_ + i);
+                set_ctrl(i, ctrl_empty);
+            } else {
+                set_ctrl(j, h2(hash));
+                policy::transfer(alloc_, spare, slots_ + i);
+                policy::transfer(alloc_, slots_ + i, slots_ + j);
+                policy::transfer(alloc_, slots_ + j, spare);
+                --i;
+            }
+        }
+        growth_left_ = capacity_to_growth(capacity_) - size_;
+    }
+
+    // Installs a fresh slot array and keeps the old one around to be
+    // drained by migrate(). Room for every old element is set aside in the
+    // new array's growth budget up front.
+    void start_migration(std::size_t new_capacity) {
+        // Only the allocation is timed; the moves are spread over later calls.
+        typename table_counters::rehash_timer timer(counters_);
+        migration_alloc alloc(alloc_);
+        migration* m = std::to_address(migration_traits::allocate(alloc, 1));
+        *m = migration{ctrl_, slots_, capacity_, 0};
+        try {
+            initialize_slots(new_capacity);
+        } catch (...) {
+            migration_traits::deallocate(alloc, m, 1);
+            throw;
+        }
+        migration_ = m;
+        growth_left_ -= size_;
+    }
+
+    // Moves the elements of up to budget old slots into the current array.
+    void migrate(std::size_t budget) {
+        migration& m = *migration_;
+        const std::size_t stop = m.capacity - m.cursor <= budget ? m.capacity : m.cursor + budget;
+        for (; m.cursor != stop; ++m.cursor) {
+            if (!is_full(m.ctrl[m.cursor])) continue;
+            slot_type* src = m.slots + m.cursor;
+            const std::size_t hash = hash_of(policy::key(*src));
+            const std::size_t j = find_first_non_full(hash);
+            set_ctrl(j, h2(hash));
+            policy::transfer(alloc_, slots_ + j, src);
+            detail::set_ctrl(m.ctrl, m.capacity, m.cursor, ctrl_deleted);
+        }
+        if (m.cursor == m.capacity) end_migration();
+    }
+
+    void end_migration() noexcept {
+        deallocate(migration_->ctrl, migration_->capacity);
+        migration_alloc alloc(alloc_);
+        migration_traits::deallocate(alloc, migration_, 1);
+        migration_ = nullptr;
+    }
+
+    // Destroys whatever is left in the old array and drops it.
+    void destroy_migration() noexcept {
+        if (!migration_) return;
+        if constexpr (!trivially_destroyed<Alloc, slot_type>) {
+            const migration& m = *migration_;
+            for (std::size_t i = m.cursor; i != m.capacity; ++i) {
+                if (is_full(m.ctrl[i])) alloc_traits::destroy(alloc_, m.slots + i);
+            }
+        }
+        end_migration();
+    }
+
+    void resize(std::size_t new_capacity) {
+        if (migration_) migrate(npos);
+        typename table_counters::rehash_timer timer(counters_);
+        ctrl_t* old_ctrl = ctrl_;
+        slot_type* old_slots = slots_;
+        const std::size_t old_capacity = capacity_;
+        initialize_slots(new_capacity);
+        for (std::size_t i = 0; i != old_capacity; ++i) {
+            if (!is_full(old_ctrl[i])) continue;
+            const std::size_t hash = hash_of(policy::key(old_slots[i]));
+            const std::size_t j = find_first_non_full(hash);
+            set_ctrl(j, h2(hash));
+            policy::transfer(alloc_, slots_ + j, old_slots + i);
+        }
+        growth_left_ -= size_;
+        if (old_capacity) deallocate(old_ctrl, old_capacity);
+    }
+
+    static constexpr std::size_t tombstone_ratio = 8;
+
+    // Regions of a parallel build and chunks of parallel_for_each are at
+    // least this many slots.
+    static constexpr std::size_t parallel_min_region = 4096;
+    static constexpr std::size_t parallel_min_chunk = 4096;
+
+    template <class R>
+    void build_parallel(const R& range, unsigned threads) {
+        using range_reference = std::ranges::range_reference_t<const R>;
+        static_assert(policy::template key_extractable<range_reference>,
+                      "parallel_build takes a range of value_type, or of key/value pairs for a map");
+        const std::size_t n = static_cast<std::size_t>(std::ranges::size(range));
+        const auto first = std::ranges::begin(range);
+        reserve(n);
+        const std::size_t slots = capacity_ + 1;
+        const std::size_t regions =
+            std::bit_floor(std::min<std::size_t>(std::size_t{threads} * 4, slots / parallel_min_region));
+        if (threads == 1 || regions < 2) {
+            for (std::size_t i = 0; i != n; ++i) emplace(first[i]);
+            return;
+        }
+        const int shift = std::countr_zero(slots) - std::countr_zero(regions);
+        const auto region_of = [&](std::size_t hash) { return (h1(hash) & capacity_) >> shift; };
+
+        // Hash every key and count the keys of each region per input chunk.
+        const std::size_t chunks = std::size_t{threads} * 4;
+        const auto chunk_begin = [&](std::size_t c) { return c * n / chunks; };
+        std::vector<std::size_t> hashes(n);
+        std::vector<std::size_t> counts(chunks * regions);
+        run_parallel(chunks, threads, [&](std::size_t c) {
+            std::size_t* count = counts.data() + c * regions;
+            for (std::size_t i = chunk_begin(c); i != chunk_begin(c + 1); ++i) {
+                hashes[i] = hash_of(policy::extract_key(first[i]));
+                ++count[region_of(hashes[i])];
+            }
+        });
+
+        // Sort the element indices by region, keeping input order within a
+        // region; counts become each chunk's write position in each region.
+        std::vector<std::size_t> region_begin(regions + 1);
+        std::size_t pos = 0;
+        for (std::size_t r = 0; r != regions; ++r) {
+            region_begin[r] = pos;
+            for (std::size_t c = 0; c != chunks; ++c) {
+                const std::size_t k = counts[c * regions + r];
+                counts[c * regions + r] = pos;
+                pos += k;
+            }
+        }
+        region_begin[regions] = n;
+        std::vector<std::size_t> order(n);
+        run_parallel(chunks, threads, [&](std::size_t c) {
+            std::size_t* next = counts.data() + c * regions;
+            for (std::size_t i = chunk_begin(c); i != chunk_begin(c + 1); ++i) order[next[region_of(hashes[i])]++] = i;
+        });
+
+        // Fill the regions. A thread touches only the control bytes and
+        // slots of its region; elements that would need more are deferred.
+        const std::size_t region_slots = slots / regions;
+        std::vector<std::size_t> added(regions);
+        std::vector<std::vector<std::size_t>> deferred(regions);
+        run_parallel(regions, threads, [&](std::size_t r) {
+            const std::size_t lo = r * region_slots;
+            std::size_t count = 0;
+            for (std::size_t k = region_begin[r]; k != region_begin[r + 1]; ++k) {
+                const std::size_t i = order[k];
+                if (!insert_in_region(first[i], hashes[i], lo, lo + region_slots, count)) deferred[r].push_back(i);
+            }
+            added[r] = count;
+        });
+        for (std::size_t count : added) {
+            size_ += count;
+            growth_left_ -= count;
+        }
+
+        // Stitch: the deferred elements, in region order and input order
+        // within a region, so the first of equal keys still wins.
+        for (const auto& list : deferred) {
+            for (std::size_t i : list) {
+                if (find_iter(policy::extract_key(first[i]), hashes[i]) == end()) {
+                    emplace_unique_unchecked(hashes[i], first[i]);
+                }
+            }
+        }
+    }
+
+    // Inserts into a table without tombstones, reading and writing only
+    // control bytes in [lo, hi). Returns false, having changed nothing, if
+    // the probe sequence reaches a group that is not wholly inside before
+    // the element is placed; otherwise bumps added unless the key was
+    // already present.
+    template <class Value>
+    bool insert_in_region(Value&& value, std::size_t hash, std::size_t lo, std::size_t hi, std::size_t& added) {
+        const ctrl_t tag = h2(hash);
+        for (probe_seq seq(h1(hash), capacity_);; seq.next()) {
+            if (seq.offset() < lo || seq.offset() + group::width > hi) return false;
+            const group g(ctrl_ + seq.offset());
+            for (std::uint32_t i : g.match(tag)) {
+                if (eq_(policy::key(slots_[seq.offset(i)]), policy::extract_key(value))) return true;
+            }
+            if (const auto empty = g.match_empty()) {
+                const std::size_t i = seq.offset(empty.lowest_bit_set());
+                alloc_traits::construct(alloc_, slots_ + i, std::forward<Value>(value));
+                set_ctrl(i, tag);
+                ++added;
+                return true;
+            }
+        }
+    }
+
+    template <class Reference, class F>
+    void for_each_parallel(F& f, unsigned threads) const {
+        if (size_ == 0) return;
+        const auto visit = [&](const ctrl_t* ctrl, slot_type* slots, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i != end; ++i) {
+                if (is_full(ctrl[i])) f(static_cast<Reference>(policy::element(slots + i)));
+            }
+        };
+        threads = parallel_threads(threads);
+        std::size_t chunk = (capacity_ + 1) / (std::size_t{threads} * 8);
+        chunk = std::max(parallel_min_chunk, chunk);
+        // An incremental resize leaves elements in the old array too.
+        const std::size_t old_capacity = migration_ ? migration_->capacity : 0;
+        const std::size_t current = (capacity_ + chunk - 1) / chunk;
+        const std::size_t tasks = current + (old_capacity + chunk - 1) / chunk;
+        run_parallel(tasks, threads, [&](std::size_t t) {
+            if (t < current) {
+                visit(ctrl_, slots_, t * chunk, std::min(t * chunk + chunk, capacity_));
+            } else {
+                const std::size_t begin = (t - current) * chunk;
+                visit(migration_->ctrl, migration_->slots, begin, std::min(begin + chunk, old_capacity));
+            }
+        });
+    }
+
+    void set_ctrl(std::size_t i, ctrl_t c) noexcept { detail::set_ctrl(ctrl_, capacity_, i, c); }
+
+    static std::size_t slot_offset(std::size_t capacity) noexcept {
+        return (capacity + 1 + cloned_bytes + alignof(slot_type) - 1) & ~(alignof(slot_type) - 1);
+    }
+
+    static std::size_t alloc_blocks(std::size_t capacity) noexcept {
+        return (slot_offset(capacity) + capacity * sizeof(slot_type) + sizeof(block) - 1) / sizeof(block);
+    }
+
+    // Allocates and installs empty storage for new_capacity slots. The old
+    // storage is left to the caller.
+    void initialize_slots(std::size_t new_capacity) {
+        block_alloc alloc(alloc_);
+        auto* mem = reinterpret_cast<unsigned char*>(std::to_address(block_traits::allocate(alloc, alloc_blocks(new_capacity))));
+        ctrl_ = reinterpret_cast<ctrl_t*>(mem);
+        slots_ = reinterpret_cast<slot_type*>(mem + slot_offset(new_capacity));
+        capacity_ = new_capacity;
+        reset_ctrl();
+        growth_left_ = capacity_to_growth(new_capacity);
+    }
+
+    void reset_ctrl() noexcept { detail::reset_ctrl(ctrl_, capacity_); }
+
+    void deallocate(ctrl_t* ctrl, std::size_t capacity) noexcept {
+        block_alloc alloc(alloc_);
+        using block_pointer = typename block_traits::pointer;
+        block_traits::deallocate(alloc, std::pointer_traits<block_pointer>::pointer_to(*reinterpret_cast<block*>(ctrl)),
+                                 alloc_blocks(capacity));
+    }
+
+    void destroy_slots() noexcept {
+        if constexpr (!trivially_destroyed<Alloc, slot_type>) {
+            for (std::size_t i = 0; i != capacity_; ++i) {
+                if (is_full(ctrl_[i])) alloc_traits::destroy(alloc_, slots_ + i);
+            }
+        }
+    }
+
+    void destroy_and_deallocate() noexcept {
+        destroy_migration();
+        if (capacity_ == 0) return;
+        destroy_slots();
+        deallocate(ctrl_, capacity_);
+    }
+
+    void reset_storage() noexcept {
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = size_ = growth_left_ = 0;
+        migration_ = nullptr;
+    }
+
+    void take_storage(raw_hash_table& other) noexcept {
+        ctrl_ = other.ctrl_;
+        slots_ = other.slots_;
+        capacity_ = other.capacity_;
+        size_ = other.size_;
+        growth_left_ = other.growth_left_;
+        migration_ = other.migration_;
+        rehash_step_ = other.rehash_step_;
+        other.reset_storage();
+    }
+
+    void swap_storage(raw_hash_table& other) noexcept(std::is_nothrow_swappable_v<Hash> &&
+                                                      std::is_nothrow_swappable_v<Eq>) {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+        swap(migration_, other.migration_);
+        swap(rehash_step_, other.rehash_step_);
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+    }
+
+    // Exchanges everything, allocator included; used by assignment where the
+    // temporary must release the old storage with the allocator that made it.
+    void swap_all(raw_hash_table& other) {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        swap_storage(other);
+    }
+
+    void move_elements_from(raw_hash_table& other) {
+        reserve(other.size_);
+        for (auto it = other.begin(); it != other.end(); ++it) {
+            emplace_unique_unchecked(hash_of(policy::key(*it.slot_)), std::move(*it.slot_));
+        }
+        other.clear();
+    }
+
+    // Runs f from a constructor, releasing whatever it built if it throws;
+    // the destructor does not run for a partially constructed object.
+    template <class F>
+    void guarded(F&& f) {
+        try {
+            f();
+        } catch (...) {
+            destroy_and_deallocate();
+            throw;
+        }
+    }
+
+    ctrl_t* ctrl_ = nullptr;
+    slot_type* slots_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    std::size_t growth_left_ = 0;
+    migration* migration_ = nullptr;
+    std::size_t rehash_step_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Eq eq_;
+    [[no_unique_address]] Alloc alloc_;
+    [[no_unique_address]] mutable table_counters counters_;
+};
+
+}  // namespace shm::detail
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "shm/detail/hash_bytes.hpp"
+#include "shm/detail/mix.hpp"
+
+namespace shm {
+
+namespace detail {
+
+inline std::uint64_t initial_hash_seed() noexcept {
+    std::uint64_t seed = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    seed ^= reinterpret_cast<std::uintptr_t>(&seed);
+    try {
+        std::random_device rd;
+        seed ^= (std::uint64_t{rd()} << 32) ^ rd();
+    } catch (...) {
+    }
+    return seed;
+}
+
+// Seeds for new hashers: random per process, distinct per instance.
+inline std::uint64_t next_hash_seed() noexcept {
+    static std::atomic<std::uint64_t> state{initial_hash_seed()};
+    return mulx64(state.fetch_add(0x9E3779B97F4A7C15ULL, std::memory_order_relaxed), hash_secret[0]);
+}
+
+class seeded_hash {
+public:
+    using is_avalanching = void;
+
+    seeded_hash() noexcept : seed_(next_hash_seed()) {}
+    explicit seeded_hash(std::uint64_t seed) noexcept : seed_(seed) {}
+
+    std::uint64_t seed() const noexcept { return seed_; }
+
+protected:
+    std::size_t hash_word(std::uint64_t v) const noexcept {
+        return static_cast<std::size_t>(mulx64(v ^ seed_, hash_secret[1]));
+    }
+
+    std::uint64_t seed_;
+};
+
+}  // namespace detail
+
+// Default hasher of the shm containers. Each instance draws a random seed,
+// so which keys collide differs from table to table and from run to run
+// and cannot be worked out from outside; pass a seed to the constructor
+// for reproducible hashing. Integers, enums and pointers go through one
+// 128-bit multiply, strings through detail::hash_bytes, and anything else
+// through std::hash followed by the same multiply (which spreads a weak
+// std::hash, but cannot undo its collisions).
+//
+// The hash for strings is transparent: std::string, std::string_view and
+// const char* hash alike, so with std::equal_to<> as the equality,
+// lookups need no temporary std::string.
+template <class T>
+struct hash : detail::seeded_hash {
+    using seeded_hash::seeded_hash;
+
+    std::size_t operator()(const T& value) const noexcept(noexcept(std::hash<T>{}(value))) {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            return hash_word(static_cast<std::uint64_t>(value));
+        } else if constexpr (std::is_pointer_v<T>) {
+            return hash_word(reinterpret_cast<std::uintptr_t>(value));
+        } else if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+            // +0.0 and -0.0 compare equal and must hash alike.
+            using bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+            return hash_word(value == T(0) ? 0 : std::bit_cast<bits>(value));
+        } else {
+            return hash_word(std::hash<T>{}(value));
+        }
+    }
+};
+
+template <>
+struct hash<std::string_view> : detail::seeded_hash {
+    using is_transparent = void;
+    using seeded_hash::seeded_hash;
+
+    std::size_t operator()(std::string_view s) const noexcept {
+        return static_cast<std::size_t>(detail::hash_bytes(s.data(), s.size(), seed_));
+    }
+};
+
+template <class Traits, class Alloc>
+struct hash<std::basic_string<char, Traits, Alloc>> : hash<std::string_view> {
+    using hash<std::string_view>::hash;
+};
+
+// Unseeded transparent hasher for string keys, built on std::hash: std::string,
+// std::string_view and const char* all hash the same, so with a transparent
+// equality such as std::equal_to<> lookups need not build a std::string.
+//
+//   shm::super_hashmap<std::string, int, shm::string_hash, std::equal_to<>> m;
+//   m.find(std::string_view(buf, len));
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    std::size_t operator()(const std::string& s) const noexcept { return (*this)(std::string_view(s)); }
+    std::size_t operator()(const char* s) const noexcept { return (*this)(std::string_view(s)); }
+};
+
+}  // namespace shm
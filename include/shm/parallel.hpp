@@ -0,0 +1,76 @@
+#pragma once
+
+// Support for the parallel bulk constructor and parallel_for_each of the
+// tables: the constructor tag and a minimal fork-join helper on std::thread.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace shm {
+
+// Selects the parallel bulk constructor:
+//
+//   std::vector<std::pair<std::uint64_t, record>> rows = load();
+//   shm::super_hashmap<std::uint64_t, record> index(shm::parallel_build, rows);
+struct parallel_build_t {
+    explicit parallel_build_t() = default;
+};
+inline constexpr parallel_build_t parallel_build{};
+
+namespace detail {
+
+// Worker count for a request of threads; 0 means one per hardware thread.
+inline unsigned parallel_threads(unsigned threads) noexcept {
+    return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs task(0) .. task(tasks - 1) on up to threads threads, the calling one
+// included, handing tasks out in order as workers become free. Returns once
+// every task has run. If a task throws, the tasks not yet started are
+// skipped and the first exception is rethrown. A thread that cannot be
+// started just leaves more tasks to the others.
+template <class Task>
+void run_parallel(std::size_t tasks, unsigned threads, Task&& task) {
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    const auto work = [&] {
+        for (std::size_t t; !failed.load(std::memory_order_relaxed) &&
+                            (t = next.fetch_add(1, std::memory_order_relaxed)) < tasks;) {
+            try {
+                task(t);
+            } catch (...) {
+                std::lock_guard lock(error_mutex);
+                if (!error) error = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    const std::size_t count = std::min<std::size_t>(threads, tasks);
+    if (count > 1) {
+        try {
+            workers.reserve(count - 1);
+            for (std::size_t i = 1; i != count; ++i) workers.emplace_back(work);
+        } catch (const std::system_error&) {
+        } catch (const std::bad_alloc&) {
+        }
+    }
+    work();
+    for (auto& w : workers) w.join();
+    if (error) std::rethrow_exception(error);
+}
+
+}  // namespace detail
+
+}  // namespace shm
@@ -0,0 +1,653 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "shm/detail/mix.hpp"
+#include "shm/hash.hpp"
+
+namespace shm {
+
+namespace detail {
+
+// Key and value types the sentinel layout can hold: integer keys, and
+// values that can be moved around with memcpy.
+template <class K, class V>
+inline constexpr bool sentinel_eligible =
+    std::is_integral_v<K> && !std::is_same_v<K, bool> &&
+    (std::is_void_v<V> || (std::is_trivially_copyable_v<V> && std::is_default_constructible_v<V>));
+
+struct no_value {};
+
+// Open addressing with linear probing over a plain key array and, for maps,
+// a parallel value array, so there is neither a control byte nor padding
+// between key and value per slot. Unused slots hold the key Empty. An
+// element whose key is Empty is kept in the table object itself, so no key
+// value is actually unavailable. Erasing shifts the rest of the cluster
+// back instead of leaving a tombstone.
+//
+// V is void for sets. Both layouts need sentinel_eligible<K, V>.
+template <class K, class V, class Hash, class Alloc, K Empty>
+class sentinel_table {
+    static_assert(sentinel_eligible<K, V>, "sentinel tables need integer keys and trivially copyable values");
+
+    static constexpr bool is_map = !std::is_void_v<V>;
+    using mapped_storage = std::conditional_t<is_map, V, no_value>;
+
+    struct alignas(std::max(alignof(K), alignof(mapped_storage))) block {
+        unsigned char bytes[std::max(alignof(K), alignof(mapped_storage))];
+    };
+    using alloc_traits = std::allocator_traits<Alloc>;
+    using block_alloc = typename alloc_traits::template rebind_alloc<block>;
+    using block_traits = std::allocator_traits<block_alloc>;
+
+    static constexpr std::size_t npos = ~std::size_t{};
+    static constexpr std::size_t min_capacity = 16;
+
+    template <bool Const>
+    class iter;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::conditional_t<is_map, std::pair<const K, mapped_storage>, K>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using allocator_type = Alloc;
+    using iterator = iter<false>;
+    using const_iterator = iter<true>;
+
+private:
+    template <bool Const>
+    class iter {
+        friend class sentinel_table;
+        using table = std::conditional_t<Const, const sentinel_table, sentinel_table>;
+
+        table* t_ = nullptr;
+        std::size_t origin_ = 0;
+        std::size_t i_ = 0;  // capacity: the Empty key; capacity + 1: end
+
+        iter(table* t, std::size_t origin, std::size_t i) noexcept : t_(t), origin_(origin), i_(i) {}
+
+        std::size_t index() const noexcept {
+            return i_ < t_->capacity_ ? (origin_ + i_) & (t_->capacity_ - 1) : i_;
+        }
+
+        void skip_empty() noexcept {
+            while (i_ < t_->capacity_ && t_->keys_[index()] == Empty) ++i_;
+            if (i_ == t_->capacity_ && !t_->has_empty_key_) ++i_;
+        }
+
+    public:
+        // A map's proxy reference is not a value_type&, so to the classic
+        // iterator requirements it is only an input iterator; the C++20
+        // concepts accept proxies and see a forward iterator.
+        using iterator_category = std::conditional_t<is_map, std::input_iterator_tag, std::forward_iterator_tag>;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = typename sentinel_table::value_type;
+        using difference_type = std::ptrdiff_t;
+        // Maps yield (key, value) reference pairs built on the fly, since
+        // keys and values live in separate arrays.
+        using reference = std::conditional_t<is_map, std::pair<const K&, std::conditional_t<Const, const mapped_storage&, mapped_storage&>>,
+                                             const K&>;
+
+        struct arrow_proxy {
+            reference ref;
+            const reference* operator->() const noexcept { return &ref; }
+        };
+        using pointer = std::conditional_t<is_map, arrow_proxy, const K*>;
+
+        iter() noexcept = default;
+
+        template <bool C = Const, std::enable_if_t<C, int> = 0>
+        iter(const iter<false>& other) noexcept : t_(other.t_), origin_(other.origin_), i_(other.i_) {}
+
+        reference operator*() const noexcept {
+            const std::size_t i = index();
+            if constexpr (is_map) {
+                if (i == t_->capacity_) return reference(empty_key, t_->empty_value_);
+                return reference(t_->keys_[i], t_->values_[i]);
+            } else {
+                return i == t_->capacity_ ? empty_key : t_->keys_[i];
+            }
+        }
+
+        pointer operator->() const noexcept {
+            if constexpr (is_map) {
+                return arrow_proxy{**this};
+            } else {
+                return std::addressof(**this);
+            }
+        }
+
+        iter& operator++() noexcept {
+            ++i_;
+            skip_empty();
+            return *this;
+        }
+
+        iter operator++(int) noexcept {
+            iter tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iter& a, const iter& b) noexcept { return a.index() == b.index(); }
+    };
+
+public:
+    sentinel_table() noexcept(std::is_nothrow_default_constructible_v<Hash> &&
+                              std::is_nothrow_default_constructible_v<Alloc>) = default;
+
+    explicit sentinel_table(size_type bucket_count, const Hash& hash = Hash(), const Alloc& alloc = Alloc())
+        : hash_(hash), alloc_(alloc) {
+        if (bucket_count) initialize(std::bit_ceil(std::max(bucket_count, min_capacity)));
+    }
+
+    sentinel_table(size_type bucket_count, const Alloc& alloc) : sentinel_table(bucket_count, Hash(), alloc) {}
+
+    explicit sentinel_table(const Alloc& alloc) : alloc_(alloc) {}
+
+    template <class InputIt>
+    sentinel_table(InputIt first, InputIt last, size_type bucket_count = 0, const Hash& hash = Hash(),
+                   const Alloc& alloc = Alloc())
+        : sentinel_table(bucket_count, hash, alloc) {
+        insert(first, last);
+    }
+
+    sentinel_table(std::initializer_list<value_type> init, size_type bucket_count = 0, const Hash& hash = Hash(),
+                   const Alloc& alloc = Alloc())
+        : sentinel_table(init.begin(), init.end(), bucket_count, hash, alloc) {}
+
+    sentinel_table(const sentinel_table& other)
+        : sentinel_table(other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
+
+    sentinel_table(const sentinel_table& other, const Alloc& alloc) : hash_(other.hash_), alloc_(alloc) {
+        copy_from(other);
+    }
+
+    sentinel_table(sentinel_table&& other) noexcept
+        : hash_(std::move(other.hash_)), alloc_(std::move(other.alloc_)) {
+        take_storage(other);
+    }
+
+    sentinel_table(sentinel_table&& other, const Alloc& alloc) : hash_(std::move(other.hash_)), alloc_(alloc) {
+        if (alloc_ == other.alloc_) {
+            take_storage(other);
+        } else {
+            copy_from(other);
+            other.clear();
+        }
+    }
+
+    ~sentinel_table() { deallocate(); }
+
+    sentinel_table& operator=(const sentinel_table& other) {
+        if (this != &other) {
+            constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+            sentinel_table tmp(other, propagate ? other.alloc_ : alloc_);
+            swap_all(tmp);
+        }
+        return *this;
+    }
+
+    sentinel_table& operator=(sentinel_table&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+        if (this == &other) return *this;
+        hash_ = std::move(other.hash_);
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            deallocate();
+            alloc_ = std::move(other.alloc_);
+            take_storage(other);
+        } else {
+            if (alloc_ == other.alloc_) {
+                deallocate();
+                take_storage(other);
+            } else {
+                // Copied into our allocator first; swapping the storage in
+                // hands the old arrays to tmp to be freed.
+                sentinel_table tmp(other, alloc_);
+                swap_storage(tmp);
+                other.clear();
+            }
+        }
+        return *this;
+    }
+
+    sentinel_table& operator=(std::initializer_list<value_type> init) {
+        clear();
+        insert(init);
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+    hasher hash_function() const { return hash_; }
+
+    // Iteration starts just past an unused slot, so erasing through the
+    // iterator (which shifts later elements of a run back) never moves an
+    // element that has already been visited.
+    iterator begin() noexcept {
+        std::size_t origin = 0;
+        while (origin < capacity_ && keys_[origin] != Empty) ++origin;
+        iterator it(this, origin, 0);
+        it.skip_empty();
+        return it;
+    }
+    iterator end() noexcept { return iterator(this, 0, capacity_ + 1); }
+    const_iterator begin() const noexcept { return const_cast<sentinel_table*>(this)->begin(); }
+    const_iterator end() const noexcept { return const_cast<sentinel_table*>(this)->end(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept {
+        return std::min<size_type>(std::numeric_limits<difference_type>::max(),
+                                   block_traits::max_size(block_alloc(alloc_)) * sizeof(block) / slot_bytes);
+    }
+
+    void clear() noexcept {
+        if (capacity_ != 0) {
+            fill_empty(keys_, capacity_);
+            growth_left_ = capacity_to_growth(capacity_);
+        }
+        has_empty_key_ = false;
+        size_ = 0;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        if constexpr (is_map) {
+            return try_emplace(value.first, value.second);
+        } else {
+            return emplace_key(value);
+        }
+    }
+
+    iterator insert(const_iterator, const value_type& value) { return insert(value).first; }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) insert(*first);
+    }
+
+    void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        if constexpr (is_map && sizeof...(Args) == 2) {
+            return try_emplace(std::forward<Args>(args)...);
+        } else {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    template <class... Args>
+        requires is_map
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return emplace_key(key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+        requires is_map
+    iterator try_emplace(const_iterator, const key_type& key, Args&&... args) {
+        return try_emplace(key, std::forward<Args>(args)...).first;
+    }
+
+    template <class M>
+        requires is_map
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+        auto res = try_emplace(key, std::forward<M>(obj));
+        if (!res.second) (*res.first).second = std::forward<M>(obj);
+        return res;
+    }
+
+    template <class M>
+        requires is_map
+    iterator insert_or_assign(const_iterator, const key_type& key, M&& obj) {
+        return insert_or_assign(key, std::forward<M>(obj)).first;
+    }
+
+    template <bool M = is_map>
+        requires M
+    mapped_storage& operator[](const key_type& key) {
+        return (*try_emplace(key).first).second;
+    }
+
+    template <bool M = is_map>
+        requires M
+    mapped_storage& at(const key_type& key) {
+        const iterator it = find(key);
+        if (it == end()) throw std::out_of_range("shm::sentinel_hashmap::at: key not found");
+        return (*it).second;
+    }
+
+    template <bool M = is_map>
+        requires M
+    const mapped_storage& at(const key_type& key) const {
+        return const_cast<sentinel_table*>(this)->at(key);
+    }
+
+    // Returns the element after pos. Erasing while iterating from begin()
+    // visits every remaining element exactly once.
+    iterator erase(const_iterator pos) noexcept {
+        iterator next(this, pos.origin_, pos.i_);
+        const std::size_t i = pos.index();
+        if (i == capacity_) {
+            has_empty_key_ = false;
+            --size_;
+        } else {
+            erase_at(i);
+        }
+        next.skip_empty();
+        return next;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept {
+        while (first != last) first = erase(first);
+        return iterator(this, last.origin_, last.i_);
+    }
+
+    size_type erase(const key_type& key) noexcept {
+        if (key == Empty) [[unlikely]] {
+            if (!has_empty_key_) return 0;
+            has_empty_key_ = false;
+            --size_;
+            return 1;
+        }
+        const std::size_t i = find_index(key);
+        if (i == npos) return 0;
+        erase_at(i);
+        return 1;
+    }
+
+    void swap(sentinel_table& other) noexcept {
+        using std::swap;
+        if constexpr (alloc_traits::propagate_on_container_swap::value) swap(alloc_, other.alloc_);
+        swap(hash_, other.hash_);
+        swap_storage(other);
+    }
+
+    friend void swap(sentinel_table& a, sentinel_table& b) noexcept { a.swap(b); }
+
+    iterator find(const key_type& key) noexcept {
+        if (key == Empty) [[unlikely]]
+            return has_empty_key_ ? iterator(this, 0, capacity_) : end();
+        const std::size_t i = find_index(key);
+        return i == npos ? end() : iterator(this, 0, i);
+    }
+
+    const_iterator find(const key_type& key) const noexcept { return const_cast<sentinel_table*>(this)->find(key); }
+
+    bool contains(const key_type& key) const noexcept {
+        if (key == Empty) [[unlikely]]
+            return has_empty_key_;
+        return find_index(key) != npos;
+    }
+
+    size_type count(const key_type& key) const noexcept { return contains(key) ? 1 : 0; }
+
+    size_type bucket_count() const noexcept { return capacity_; }
+    float load_factor() const noexcept {
+        return capacity_ ? static_cast<float>(size_) / static_cast<float>(capacity_) : 0.0f;
+    }
+    float max_load_factor() const noexcept { return 7.0f / 8.0f; }
+    void max_load_factor(float) noexcept {}
+
+    // Bytes of table storage held from the allocator.
+    size_type memory_usage() const noexcept { return capacity_ ? alloc_blocks(capacity_) * sizeof(block) : 0; }
+
+    void rehash(size_type bucket_count) {
+        if (bucket_count == 0 && size_ == static_cast<size_type>(has_empty_key_)) {
+            deallocate();
+            keys_ = nullptr;
+            values_ = nullptr;
+            capacity_ = growth_left_ = 0;
+            return;
+        }
+        std::size_t wanted = std::bit_ceil(std::max({bucket_count, min_capacity, std::size_t{1}}));
+        while (capacity_to_growth(wanted) < size_) wanted *= 2;
+        if (wanted != capacity_) resize(wanted);
+    }
+
+    void reserve(size_type count) {
+        if (count > size_ + growth_left_) {
+            std::size_t wanted = std::max(capacity_, min_capacity);
+            while (capacity_to_growth(wanted) < count) wanted *= 2;
+            resize(wanted);
+        }
+    }
+
+    template <class Pred>
+    friend size_type erase_if(sentinel_table& table, Pred pred) {
+        const auto old_size = table.size();
+        for (auto it = table.begin(); it != table.end();) {
+            if (pred(*it)) {
+                it = table.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return old_size - table.size();
+    }
+
+    friend bool operator==(const sentinel_table& a, const sentinel_table& b) {
+        if (a.size_ != b.size_) return false;
+        for (const auto& v : a) {
+            if constexpr (is_map) {
+                const auto it = b.find(v.first);
+                if (it == b.end() || !((*it).second == v.second)) return false;
+            } else {
+                if (!b.contains(v)) return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr K empty_key = Empty;
+    static constexpr std::size_t slot_bytes = sizeof(K) + (is_map ? sizeof(mapped_storage) : 0);
+
+    static constexpr std::size_t capacity_to_growth(std::size_t capacity) noexcept { return capacity - capacity / 8; }
+
+    std::size_t home(K key) const noexcept { return detail::hash_value(hash_, key) & (capacity_ - 1); }
+
+    std::size_t find_index(K key) const noexcept {
+        if (capacity_ == 0) return npos;
+        const std::size_t mask = capacity_ - 1;
+        for (std::size_t i = home(key);; i = (i + 1) & mask) {
+            if (keys_[i] == key) return i;
+            if (keys_[i] == Empty) return npos;
+        }
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace_key(K key, Args&&... args) {
+        if (key == Empty) [[unlikely]] {
+            if (has_empty_key_) return {iterator(this, 0, capacity_), false};
+            if constexpr (is_map) empty_value_ = mapped_storage(std::forward<Args>(args)...);
+            has_empty_key_ = true;
+            ++size_;
+            return {iterator(this, 0, capacity_), true};
+        }
+        std::size_t i = npos;
+        if (capacity_ != 0) {
+            const std::size_t mask = capacity_ - 1;
+            for (i = home(key);; i = (i + 1) & mask) {
+                if (keys_[i] == key) return {iterator(this, 0, i), false};
+                if (keys_[i] == Empty) break;
+            }
+        }
+        if (growth_left_ == 0) {
+            resize(capacity_ ? capacity_ * 2 : min_capacity);
+            i = find_empty(key);
+        }
+        if constexpr (is_map) std::construct_at(values_ + i, std::forward<Args>(args)...);
+        keys_[i] = key;
+        --growth_left_;
+        ++size_;
+        return {iterator(this, 0, i), true};
+    }
+
+    std::size_t find_empty(K key) const noexcept {
+        const std::size_t mask = capacity_ - 1;
+        std::size_t i = home(key);
+        while (keys_[i] != Empty) i = (i + 1) & mask;
+        return i;
+    }
+
+    // Backward-shift deletion: walk the rest of the run and pull back every
+    // element whose probe path passes through the hole.
+    void erase_at(std::size_t i) noexcept {
+        const std::size_t mask = capacity_ - 1;
+        for (std::size_t j = (i + 1) & mask; keys_[j] != Empty; j = (j + 1) & mask) {
+            if (((j - home(keys_[j])) & mask) >= ((j - i) & mask)) {
+                keys_[i] = keys_[j];
+                if constexpr (is_map) values_[i] = values_[j];
+                i = j;
+            }
+        }
+        keys_[i] = Empty;
+        --size_;
+        ++growth_left_;
+    }
+
+    static std::size_t alloc_blocks(std::size_t capacity) noexcept {
+        return (values_offset(capacity) + (is_map ? capacity * sizeof(mapped_storage) : 0) + sizeof(block) - 1) /
+               sizeof(block);
+    }
+
+    static std::size_t values_offset(std::size_t capacity) noexcept {
+        const std::size_t a = alignof(mapped_storage);
+        return (capacity * sizeof(K) + a - 1) & ~(a - 1);
+    }
+
+    static void fill_empty(K* keys, std::size_t n) noexcept {
+        if constexpr (Empty == K{}) {
+            std::memset(keys, 0, n * sizeof(K));
+        } else {
+            std::fill_n(keys, n, Empty);
+        }
+    }
+
+    void initialize(std::size_t capacity) {
+        block_alloc alloc(alloc_);
+        auto* mem = reinterpret_cast<unsigned char*>(std::to_address(block_traits::allocate(alloc, alloc_blocks(capacity))));
+        keys_ = reinterpret_cast<K*>(mem);
+        if constexpr (is_map) values_ = reinterpret_cast<mapped_storage*>(mem + values_offset(capacity));
+        capacity_ = capacity;
+        fill_empty(keys_, capacity);
+        growth_left_ = capacity_to_growth(capacity);
+    }
+
+    void resize(std::size_t new_capacity) {
+        K* old_keys = keys_;
+        mapped_storage* old_values = values_;
+        const std::size_t old_capacity = capacity_;
+        initialize(new_capacity);
+        for (std::size_t i = 0; i != old_capacity; ++i) {
+            if (old_keys[i] == Empty) continue;
+            const std::size_t j = find_empty(old_keys[i]);
+            keys_[j] = old_keys[i];
+            if constexpr (is_map) values_[j] = old_values[i];
+        }
+        growth_left_ -= size_ - has_empty_key_;
+        if (old_capacity) deallocate(old_keys, old_capacity);
+    }
+
+    void copy_from(const sentinel_table& other) {
+        if (other.capacity_) {
+            initialize(other.capacity_);
+            std::memcpy(keys_, other.keys_, capacity_ * sizeof(K));
+            if constexpr (is_map) std::memcpy(values_, other.values_, capacity_ * sizeof(mapped_storage));
+        }
+        growth_left_ = other.growth_left_;
+        size_ = other.size_;
+        has_empty_key_ = other.has_empty_key_;
+        empty_value_ = other.empty_value_;
+    }
+
+    void deallocate(K* keys, std::size_t capacity) noexcept {
+        block_alloc alloc(alloc_);
+        using block_pointer = typename block_traits::pointer;
+        block_traits::deallocate(alloc, std::pointer_traits<block_pointer>::pointer_to(*reinterpret_cast<block*>(keys)),
+                                 alloc_blocks(capacity));
+    }
+
+    void deallocate() noexcept {
+        if (capacity_) deallocate(keys_, capacity_);
+    }
+
+    void take_storage(sentinel_table& other) noexcept {
+        keys_ = std::exchange(other.keys_, nullptr);
+        values_ = std::exchange(other.values_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        size_ = std::exchange(other.size_, 0);
+        growth_left_ = std::exchange(other.growth_left_, 0);
+        has_empty_key_ = std::exchange(other.has_empty_key_, false);
+        empty_value_ = other.empty_value_;
+    }
+
+    void swap_storage(sentinel_table& other) noexcept {
+        using std::swap;
+        swap(keys_, other.keys_);
+        swap(values_, other.values_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+        swap(has_empty_key_, other.has_empty_key_);
+        swap(empty_value_, other.empty_value_);
+    }
+
+    void swap_all(sentinel_table& other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        swap(hash_, other.hash_);
+        swap_storage(other);
+    }
+
+    K* keys_ = nullptr;
+    mapped_storage* values_ = nullptr;
+    std::size_t capacity_ = 0;  // a power of two, or 0
+    std::size_t size_ = 0;      // includes the Empty key when present
+    std::size_t growth_left_ = 0;
+    bool has_empty_key_ = false;
+    [[no_unique_address]] mapped_storage empty_value_{};
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Alloc alloc_;
+};
+
+}  // namespace detail
+
+// Compact hash map for integer keys and small trivially copyable values:
+// keys and values are stored in two flat arrays with no control bytes, and
+// Empty marks unused slots (any key, Empty included, can be stored). Meant
+// for large ID maps where the per-element footprint matters most.
+//
+// Iterators yield std::pair<const K&, V&> proxies rather than references to
+// a stored pair; it->second and structured bindings by value work as with
+// super_hashmap. Insertion invalidates iterators; erase(iterator) returns the
+// next element.
+template <class K, class V, class Hash = shm::hash<K>, class Alloc = std::allocator<std::pair<const K, V>>, K Empty = K{}>
+using sentinel_hashmap = detail::sentinel_table<K, V, Hash, Alloc, Empty>;
+
+// The set counterpart: a single array of keys.
+template <class K, class Hash = shm::hash<K>, class Alloc = std::allocator<K>, K Empty = K{}>
+using sentinel_hashset = detail::sentinel_table<K, void, Hash, Alloc, Empty>;
+
+}  // namespace shm
@@ -0,0 +1,523 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "shm/detail/ctrl.hpp"
+#include "shm/detail/group.hpp"
+#include "shm/detail/raw_hash_table.hpp"
+#include "shm/hash.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SHM_SNAPSHOT_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// On-disk snapshots of tables with trivially copyable keys and values.
+//
+// A snapshot file is the table itself: a fixed header followed by the
+// control bytes and the slot array, laid out exactly as a lookup needs
+// them and addressed only by offsets from the start of the file. A
+// snapshot_view maps it read-only and answers lookups straight from the
+// mapping, with no deserialisation step. A snapshot_writer builds the file
+// in place through a shared writable mapping, so the table is never held
+// in anonymous memory as well as in the file.
+//
+// Files are portable between processes and builds that agree on byte
+// order, group width (see group.hpp), the key and value layouts, and the
+// hash function. For hashers with a per-instance seed, the seed is stored
+// in the header and handed back to the hasher when the file is opened.
+namespace shm {
+
+template <class K, class V>
+struct snapshot_entry {
+    K first;
+    V second;
+};
+
+namespace detail {
+
+// A hasher whose behaviour is fully described by a 64-bit seed.
+template <class Hash>
+concept seeded_hasher = requires(const Hash& h) {
+    { h.seed() } -> std::convertible_to<std::uint64_t>;
+} && std::constructible_from<Hash, std::uint64_t>;
+
+template <class Hash>
+std::uint64_t hasher_seed(const Hash& hash) noexcept {
+    if constexpr (seeded_hasher<Hash>) {
+        return static_cast<std::uint64_t>(hash.seed());
+    } else {
+        return 0;
+    }
+}
+
+template <class Hash>
+Hash hasher_from_seed(std::uint64_t seed) {
+    if constexpr (seeded_hasher<Hash>) {
+        return Hash(seed);
+    } else {
+        return Hash();
+    }
+}
+
+struct snapshot_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t group_width;
+    std::uint32_t key_size;
+    std::uint32_t key_align;
+    std::uint32_t value_size;
+    std::uint32_t value_align;
+    std::uint32_t slot_size;
+    std::uint64_t capacity;
+    std::uint64_t size;
+    std::uint64_t hash_seed;
+    std::uint64_t ctrl_offset;
+    std::uint64_t slots_offset;
+    std::uint64_t file_size;
+    double max_load_factor;
+};
+
+inline constexpr char snapshot_magic[8] = {'S', 'H', 'M', 'S', 'N', 'A', 'P', '\0'};
+inline constexpr std::uint32_t snapshot_version = 2;
+inline constexpr std::uint32_t snapshot_byte_order = 0x01020304;
+inline constexpr std::size_t snapshot_align = 64;
+
+constexpr std::uint64_t snapshot_align_up(std::uint64_t n, std::uint64_t a) noexcept { return (n + a - 1) & ~(a - 1); }
+
+template <class K, class V>
+snapshot_header make_snapshot_header(std::uint64_t capacity, std::uint64_t hash_seed) noexcept {
+    using entry = snapshot_entry<K, V>;
+    snapshot_header h{};
+    h.version = snapshot_version;
+    h.byte_order = snapshot_byte_order;
+    h.group_width = static_cast<std::uint32_t>(group::width);
+    h.key_size = sizeof(K);
+    h.key_align = alignof(K);
+    h.value_size = sizeof(V);
+    h.value_align = alignof(V);
+    h.slot_size = sizeof(entry);
+    h.capacity = capacity;
+    h.hash_seed = hash_seed;
+    h.ctrl_offset = snapshot_align_up(sizeof(snapshot_header), snapshot_align);
+    h.slots_offset = snapshot_align_up(h.ctrl_offset + capacity + 1 + cloned_bytes,
+                                       std::max<std::uint64_t>(snapshot_align, alignof(entry)));
+    h.file_size = h.slots_offset + capacity * sizeof(entry);
+    h.max_load_factor = 7.0 / 8.0;
+    return h;
+}
+
+[[noreturn]] inline void throw_snapshot_error(const std::string& what) {
+    throw std::runtime_error("shm snapshot: " + what);
+}
+
+[[noreturn]] inline void throw_snapshot_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), "shm snapshot: " + what);
+}
+
+}  // namespace detail
+
+// Read-only view of a snapshot, either mapped from a file or over memory
+// the caller keeps alive. Opening checks the header and scans the control
+// bytes once, so a damaged file throws rather than making lookups spin.
+template <class K, class V, class Hash = shm::hash<K>, class Eq = std::equal_to<K>>
+class snapshot_view {
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "snapshots store keys and values as raw bytes");
+
+    template <class Key>
+    using key_arg = detail::key_arg<Hash, Eq, Key, K>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = snapshot_entry<K, V>;
+    using size_type = std::size_t;
+
+    class const_iterator {
+        friend class snapshot_view;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = snapshot_entry<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = const value_type&;
+        using pointer = const value_type*;
+
+    private:
+        const detail::ctrl_t* ctrl_ = nullptr;
+        const value_type* slot_ = nullptr;
+
+        const_iterator(const detail::ctrl_t* ctrl, const value_type* slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+
+        void skip_empty_or_deleted() noexcept {
+            while (detail::is_empty_or_deleted(*ctrl_)) {
+                const std::uint32_t shift = detail::group(ctrl_).count_leading_empty_or_deleted();
+                ctrl_ += shift;
+                slot_ += shift;
+            }
+        }
+
+    public:
+        const_iterator() noexcept = default;
+
+        reference operator*() const noexcept { return *slot_; }
+        pointer operator->() const noexcept { return slot_; }
+
+        const_iterator& operator++() noexcept {
+            ++ctrl_;
+            ++slot_;
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept {
+            return a.ctrl_ == b.ctrl_;
+        }
+    };
+
+    using iterator = const_iterator;
+
+#if defined(SHM_SNAPSHOT_HAS_MMAP)
+    // Maps the file read-only. The mapping lives as long as the view.
+    explicit snapshot_view(const std::string& path, const Eq& eq = Eq()) : eq_(eq) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) detail::throw_snapshot_errno("open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            errno = err;
+            detail::throw_snapshot_errno("stat " + path);
+        }
+        const auto bytes = static_cast<std::size_t>(st.st_size);
+        void* mem = bytes ? ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        const int err = errno;
+        ::close(fd);
+        if (mem == MAP_FAILED) {
+            if (bytes == 0) detail::throw_snapshot_error(path + " is empty");
+            errno = err;
+            detail::throw_snapshot_errno("mmap " + path);
+        }
+        mapping_ = mem;
+        mapping_size_ = bytes;
+        try {
+            attach(mem, bytes);
+        } catch (...) {
+            ::munmap(mapping_, mapping_size_);
+            throw;
+        }
+    }
+#endif
+
+    // Views a snapshot image already in memory, e.g. mapped by the caller.
+    // data must be aligned to 64 bytes and outlive the view.
+    snapshot_view(const void* data, std::size_t bytes, const Eq& eq = Eq()) : eq_(eq) { attach(data, bytes); }
+
+    snapshot_view(snapshot_view&& other) noexcept
+        : header_(other.header_),
+          ctrl_(other.ctrl_),
+          slots_(other.slots_),
+          mapping_(std::exchange(other.mapping_, nullptr)),
+          mapping_size_(std::exchange(other.mapping_size_, 0)),
+          hash_(std::move(other.hash_)),
+          eq_(std::move(other.eq_)) {}
+
+    snapshot_view& operator=(snapshot_view&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            header_ = other.header_;
+            ctrl_ = other.ctrl_;
+            slots_ = other.slots_;
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            mapping_size_ = std::exchange(other.mapping_size_, 0);
+            hash_ = std::move(other.hash_);
+            eq_ = std::move(other.eq_);
+        }
+        return *this;
+    }
+
+    snapshot_view(const snapshot_view&) = delete;
+    snapshot_view& operator=(const snapshot_view&) = delete;
+
+    ~snapshot_view() { unmap(); }
+
+    template <class Key = K>
+    const_iterator find(const key_arg<Key>& key) const {
+        const std::size_t hash = detail::hash_value(hash_, key);
+        const std::size_t capacity = header_->capacity;
+        const detail::ctrl_t tag = detail::h2(hash);
+        // Bounded, unlike the in-memory tables: the file may have been
+        // damaged after attach() checked it.
+        for (detail::probe_seq seq(detail::h1(hash), capacity); seq.index() <= capacity; seq.next()) {
+            const detail::group g(ctrl_ + seq.offset());
+            for (std::uint32_t i : g.match(tag)) {
+                const std::size_t idx = seq.offset(i);
+                if (eq_(slots_[idx].first, key)) [[likely]]
+                    return const_iterator(ctrl_ + idx, slots_ + idx);
+            }
+            if (g.match_empty()) [[likely]]
+                return end();
+        }
+        return end();
+    }
+
+    template <class Key = K>
+    bool contains(const key_arg<Key>& key) const {
+        return find<Key>(key) != end();
+    }
+
+    template <class Key = K>
+    size_type count(const key_arg<Key>& key) const {
+        return contains<Key>(key) ? 1 : 0;
+    }
+
+    template <class Key = K>
+    const V& at(const key_arg<Key>& key) const {
+        auto it = find<Key>(key);
+        if (it == end()) throw std::out_of_range("shm::snapshot_view::at: key not found");
+        return it->second;
+    }
+
+    const_iterator begin() const noexcept {
+        if (header_->size == 0) return end();
+        const_iterator it(ctrl_, slots_);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    const_iterator end() const noexcept { return const_iterator(ctrl_ + header_->capacity, slots_ + header_->capacity); }
+
+    size_type size() const noexcept { return static_cast<size_type>(header_->size); }
+    bool empty() const noexcept { return size() == 0; }
+    size_type bucket_count() const noexcept { return static_cast<size_type>(header_->capacity); }
+    float load_factor() const noexcept { return static_cast<float>(header_->size) / static_cast<float>(header_->capacity); }
+    float max_load_factor() const noexcept { return static_cast<float>(header_->max_load_factor); }
+    std::uint64_t hash_seed() const noexcept { return header_->hash_seed; }
+    Hash hash_function() const { return hash_; }
+    Eq key_eq() const { return eq_; }
+
+private:
+    void attach(const void* data, std::size_t bytes) {
+        if (reinterpret_cast<std::uintptr_t>(data) % detail::snapshot_align != 0) {
+            detail::throw_snapshot_error("image is not 64-byte aligned");
+        }
+        if (bytes < sizeof(detail::snapshot_header)) detail::throw_snapshot_error("truncated header");
+        const auto* h = static_cast<const detail::snapshot_header*>(data);
+        if (std::memcmp(h->magic, detail::snapshot_magic, sizeof(h->magic)) != 0) {
+            detail::throw_snapshot_error("bad magic (not a snapshot, or not finished)");
+        }
+        if (h->version != detail::snapshot_version) detail::throw_snapshot_error("unsupported version");
+        if (h->byte_order != detail::snapshot_byte_order) detail::throw_snapshot_error("byte order mismatch");
+        if (h->group_width != detail::group::width) detail::throw_snapshot_error("built with a different group width");
+        const detail::snapshot_header expected = detail::make_snapshot_header<K, V>(h->capacity, h->hash_seed);
+        if (h->key_size != expected.key_size || h->key_align != expected.key_align ||
+            h->value_size != expected.value_size || h->value_align != expected.value_align ||
+            h->slot_size != expected.slot_size) {
+            detail::throw_snapshot_error("key or value layout mismatch");
+        }
+        if (h->capacity < detail::min_capacity || h->capacity > (std::uint64_t{1} << 48) ||
+            ((h->capacity + 1) & h->capacity) != 0 ||
+            h->size > detail::capacity_to_growth(h->capacity) || h->ctrl_offset != expected.ctrl_offset ||
+            h->slots_offset != expected.slots_offset || h->file_size != expected.file_size || h->file_size > bytes) {
+            detail::throw_snapshot_error("corrupt header");
+        }
+        const auto* base = static_cast<const unsigned char*>(data);
+        const auto* ctrl = reinterpret_cast<const detail::ctrl_t*>(base + h->ctrl_offset);
+        if (ctrl[h->capacity] != detail::ctrl_sentinel) detail::throw_snapshot_error("corrupt control bytes");
+        // Writers leave no tombstones, and size counts the full slots; with
+        // size within the growth limit that guarantees the empty slots that
+        // end unsuccessful probes.
+        std::uint64_t full = 0;
+        for (std::uint64_t i = 0; i != h->capacity; ++i) {
+            if (detail::is_full(ctrl[i])) {
+                ++full;
+            } else if (!detail::is_empty(ctrl[i])) {
+                detail::throw_snapshot_error("corrupt control bytes");
+            }
+        }
+        if (full != h->size) detail::throw_snapshot_error("corrupt control bytes");
+        header_ = h;
+        ctrl_ = ctrl;
+        slots_ = reinterpret_cast<const value_type*>(base + h->slots_offset);
+        hash_ = detail::hasher_from_seed<Hash>(h->hash_seed);
+    }
+
+    void unmap() noexcept {
+#if defined(SHM_SNAPSHOT_HAS_MMAP)
+        if (mapping_) ::munmap(mapping_, mapping_size_);
+#endif
+        mapping_ = nullptr;
+    }
+
+    const detail::snapshot_header* header_ = nullptr;
+    const detail::ctrl_t* ctrl_ = nullptr;
+    const value_type* slots_ = nullptr;
+    void* mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Eq eq_;
+};
+
+#if defined(SHM_SNAPSHOT_HAS_MMAP)
+
+// Builds a snapshot file in place. The capacity is fixed up front from the
+// expected element count; inserting more than that throws. Entries go
+// straight into a shared writable mapping of the file, so memory use is
+// bounded by the page cache rather than by a second copy of the table.
+// The magic is written last, by finish(), once everything else is on disk,
+// so a file left behind by a crashed writer is rejected when opened. A
+// writer destroyed without finish(), e.g. during unwinding, removes the
+// file instead.
+template <class K, class V, class Hash = shm::hash<K>, class Eq = std::equal_to<K>>
+class snapshot_writer {
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "snapshots store keys and values as raw bytes");
+
+    using entry = snapshot_entry<K, V>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+
+    snapshot_writer(const std::string& path, size_type expected_count, const Hash& hash = Hash(), const Eq& eq = Eq())
+        : path_(path), hash_(hash), eq_(eq) {
+        const std::size_t capacity = detail::growth_to_capacity(std::max<size_type>(expected_count, 1));
+        const detail::snapshot_header header =
+            detail::make_snapshot_header<K, V>(capacity, detail::hasher_seed(hash));
+
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) detail::throw_snapshot_errno("open " + path);
+        size_ = static_cast<std::size_t>(header.file_size);
+        if (::ftruncate(fd_, static_cast<off_t>(size_)) != 0) fail("truncate " + path);
+        void* mem = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mem == MAP_FAILED) fail("mmap " + path);
+        base_ = static_cast<unsigned char*>(mem);
+
+        header_ = ::new (base_) detail::snapshot_header(header);
+        ctrl_ = reinterpret_cast<detail::ctrl_t*>(base_ + header.ctrl_offset);
+        slots_ = reinterpret_cast<entry*>(base_ + header.slots_offset);
+        capacity_ = capacity;
+        growth_left_ = detail::capacity_to_growth(capacity);
+        detail::reset_ctrl(ctrl_, capacity_);
+    }
+
+    snapshot_writer(const snapshot_writer&) = delete;
+    snapshot_writer& operator=(const snapshot_writer&) = delete;
+
+    // Abandons the file if finish() was not called: nothing half written
+    // is ever published.
+    ~snapshot_writer() {
+        if (base_) abandon();
+    }
+
+    // Adds key -> value unless key is already present; returns whether it
+    // was added.
+    bool insert(const K& key, const V& value) {
+        const std::size_t hash = detail::hash_value(hash_, key);
+        const detail::ctrl_t tag = detail::h2(hash);
+        for (detail::probe_seq seq(detail::h1(hash), capacity_);; seq.next()) {
+            const detail::group g(ctrl_ + seq.offset());
+            for (std::uint32_t i : g.match(tag)) {
+                if (eq_(slots_[seq.offset(i)].first, key)) return false;
+            }
+            if (g.match_empty()) break;
+        }
+        if (growth_left_ == 0) throw std::length_error("shm::snapshot_writer: more entries than expected_count");
+        const std::size_t i = detail::find_first_non_full(ctrl_, capacity_, hash);
+        std::memcpy(&slots_[i].first, &key, sizeof(K));
+        std::memcpy(&slots_[i].second, &value, sizeof(V));
+        detail::set_ctrl(ctrl_, capacity_, i, tag);
+        --growth_left_;
+        ++header_->size;
+        return true;
+    }
+
+    template <class Range>
+    void insert_range(const Range& range) {
+        for (const auto& [key, value] : range) insert(key, value);
+    }
+
+    size_type size() const noexcept { return static_cast<size_type>(header_->size); }
+
+    // Flushes the table to the file, then stamps the magic and flushes the
+    // header, so the magic never reaches the disk ahead of the data it
+    // vouches for. On failure the file is removed and the error rethrown.
+    void finish() {
+        if (!base_) return;
+        if (::msync(base_, size_, MS_SYNC) != 0) fail("msync " + path_);
+        std::memcpy(header_->magic, detail::snapshot_magic, sizeof(header_->magic));
+        if (::msync(base_, sizeof(detail::snapshot_header), MS_SYNC) != 0) fail("msync " + path_);
+        ::munmap(base_, size_);
+        base_ = nullptr;
+        const int fd = std::exchange(fd_, -1);
+        if (::close(fd) != 0) fail("close " + path_);
+    }
+
+private:
+    // Unmaps, closes and removes the file.
+    void abandon() noexcept {
+        if (base_) ::munmap(base_, size_);
+        base_ = nullptr;
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        ::unlink(path_.c_str());
+    }
+
+    [[noreturn]] void fail(const std::string& what) {
+        const int err = errno;
+        abandon();
+        errno = err;
+        detail::throw_snapshot_errno(what);
+    }
+
+    std::string path_;
+    int fd_ = -1;
+    unsigned char* base_ = nullptr;
+    std::size_t size_ = 0;
+    detail::snapshot_header* header_ = nullptr;
+    detail::ctrl_t* ctrl_ = nullptr;
+    entry* slots_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t growth_left_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Eq eq_;
+};
+
+// Streams every element of a map (anything iterable as key/value pairs with
+// a size()) into a new snapshot file at path.
+template <class Map>
+void write_snapshot(const std::string& path, const Map& map) {
+    using K = typename Map::key_type;
+    using V = typename Map::mapped_type;
+    snapshot_writer<K, V, typename Map::hasher, typename Map::key_equal> writer(path, map.size(), map.hash_function(),
+                                                                               map.key_eq());
+    writer.insert_range(map);
+    writer.finish();
+}
+
+#endif  // SHM_SNAPSHOT_HAS_MMAP
+
+}  // namespace shm
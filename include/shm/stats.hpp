@@ -0,0 +1,142 @@
+#pragma once
+
+// Table statistics for diagnosing hash quality. The layout figures (load,
+// tombstones, displacement) are computed on demand by stats() and always
+// available. The event counters (probe-length histograms, rehash count and
+// time) are compiled in only with SHM_ENABLE_STATS defined to 1; without
+// it the tables carry no counter members and record nothing. Every
+// translation unit in a program must agree on the setting.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#ifndef SHM_ENABLE_STATS
+#define SHM_ENABLE_STATS 0
+#endif
+
+namespace shm {
+
+struct table_stats {
+    // Probe lengths in groups: entry k counts lookups that examined k + 1
+    // groups; the last entry also takes everything longer.
+    static constexpr std::size_t histogram_size = 16;
+
+    std::size_t size = 0;
+    std::size_t capacity = 0;
+    double load_factor = 0;
+    std::size_t tombstones = 0;
+    // Distance, in groups, between an element's first probe group and the
+    // group it sits in; 0 for an element in its home group.
+    std::size_t max_displacement = 0;
+    double mean_displacement = 0;
+
+    bool counters_enabled = SHM_ENABLE_STATS != 0;
+    std::array<std::uint64_t, histogram_size> hit_probes{};
+    std::array<std::uint64_t, histogram_size> miss_probes{};
+    std::uint64_t rehashes = 0;
+    std::uint64_t rehash_ns = 0;
+};
+
+// Multi-line human-readable rendering of s.
+inline std::string to_string(const table_stats& s) {
+    std::string out;
+    const auto line = [&](const char* name, const std::string& value) {
+        out += name;
+        out += value;
+        out += '\n';
+    };
+    line("size:              ", std::to_string(s.size));
+    line("capacity:          ", std::to_string(s.capacity));
+    line("load factor:       ", std::to_string(s.load_factor));
+    line("tombstones:        ", std::to_string(s.tombstones));
+    line("max displacement:  ", std::to_string(s.max_displacement) + " groups");
+    line("mean displacement: ", std::to_string(s.mean_displacement) + " groups");
+    if (!s.counters_enabled) {
+        out += "(probe and rehash counters disabled; build with SHM_ENABLE_STATS=1)\n";
+        return out;
+    }
+    line("rehashes:          ", std::to_string(s.rehashes) + " (" + std::to_string(s.rehash_ns / 1000) + " us)");
+    const auto histogram = [&](const char* name, const auto& h) {
+        std::string row;
+        for (std::size_t k = 0; k != h.size(); ++k) {
+            if (!h[k]) continue;
+            row += ' ' + std::to_string(k + 1) + (k + 1 == h.size() ? "+:" : ":") + std::to_string(h[k]);
+        }
+        line(name, row.empty() ? " -" : row);
+    };
+    histogram("probes on hit:    ", s.hit_probes);
+    histogram("probes on miss:   ", s.miss_probes);
+    return out;
+}
+
+namespace detail {
+
+// Event counters owned by one table object. Relaxed atomics, so const
+// lookups from several threads may record at once. Copying or moving a
+// table starts it with fresh counters.
+struct stats_counters {
+    std::array<std::atomic<std::uint64_t>, table_stats::histogram_size> hit_probes{};
+    std::array<std::atomic<std::uint64_t>, table_stats::histogram_size> miss_probes{};
+    std::atomic<std::uint64_t> rehashes{0};
+    std::atomic<std::uint64_t> rehash_ns{0};
+
+    stats_counters() = default;
+    stats_counters(const stats_counters&) noexcept {}
+    stats_counters& operator=(const stats_counters&) noexcept { return *this; }
+
+    static void bump(std::atomic<std::uint64_t>& c, std::uint64_t n = 1) noexcept {
+        c.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void record_probe(bool hit, std::size_t groups) noexcept {
+        const std::size_t k = groups < table_stats::histogram_size ? groups - 1 : table_stats::histogram_size - 1;
+        bump(hit ? hit_probes[k] : miss_probes[k]);
+    }
+
+    void copy_to(table_stats& s) const noexcept {
+        for (std::size_t k = 0; k != table_stats::histogram_size; ++k) {
+            s.hit_probes[k] = hit_probes[k].load(std::memory_order_relaxed);
+            s.miss_probes[k] = miss_probes[k].load(std::memory_order_relaxed);
+        }
+        s.rehashes = rehashes.load(std::memory_order_relaxed);
+        s.rehash_ns = rehash_ns.load(std::memory_order_relaxed);
+    }
+
+    // Counts one rehash and adds its duration when destroyed.
+    class rehash_timer {
+    public:
+        explicit rehash_timer(stats_counters& c) noexcept : c_(c), start_(std::chrono::steady_clock::now()) {}
+        ~rehash_timer() {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+            bump(c_.rehashes);
+            bump(c_.rehash_ns, static_cast<std::uint64_t>(ns.count()));
+        }
+        rehash_timer(const rehash_timer&) = delete;
+        rehash_timer& operator=(const rehash_timer&) = delete;
+
+    private:
+        stats_counters& c_;
+        std::chrono::steady_clock::time_point start_;
+    };
+};
+
+// Stand-in with the same interface when the counters are compiled out.
+struct null_stats {
+    void record_probe(bool, std::size_t) const noexcept {}
+    void copy_to(table_stats&) const noexcept {}
+
+    struct rehash_timer {
+        explicit rehash_timer(const null_stats&) noexcept {}
+    };
+};
+
+using table_counters = std::conditional_t<SHM_ENABLE_STATS != 0, stats_counters, null_stats>;
+
+}  // namespace detail
+
+}  // namespace shm
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "shm/detail/raw_hash_table.hpp"
+#include "shm/hash.hpp"
+
+namespace shm {
+
+namespace detail {
+
+template <class T>
+struct is_pair : std::false_type {};
+template <class A, class B>
+struct is_pair<std::pair<A, B>> : std::true_type {};
+
+template <class K, class V>
+struct map_policy {
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using slot_type = value_type;
+    static constexpr bool constant_iterators = false;
+
+    static const K& key(const slot_type& slot) noexcept { return slot.first; }
+    static value_type& element(slot_type* slot) noexcept { return *slot; }
+
+    // Moves an element into uninitialised storage and destroys the source.
+    // The key is moved out through a const_cast: the source is destroyed
+    // immediately afterwards and never observed again.
+    template <class Alloc>
+    static void transfer(Alloc& alloc, slot_type* dst, slot_type* src) {
+        std::allocator_traits<Alloc>::construct(alloc, dst, std::move(const_cast<K&>(src->first)),
+                                                std::move(src->second));
+        std::allocator_traits<Alloc>::destroy(alloc, src);
+    }
+
+    // emplace() can look the key up before constructing anything when it is
+    // passed as (key, mapped...) or as a single pair.
+    template <class... Args>
+    static constexpr bool key_extractable = [] {
+        if constexpr (sizeof...(Args) == 2) {
+            using first = std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Args...>>>;
+            return std::is_same_v<first, K>;
+        } else if constexpr (sizeof...(Args) == 1) {
+            using arg = std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Args...>>>;
+            if constexpr (is_pair<arg>::value) {
+                return std::is_same_v<std::remove_cvref_t<typename arg::first_type>, K>;
+            } else {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }();
+
+    template <class First, class... Rest>
+    static const K& extract_key(const First& first, const Rest&...) noexcept {
+        if constexpr (sizeof...(Rest) == 0) {
+            return first.first;
+        } else {
+            return first;
+        }
+    }
+};
+
+}  // namespace detail
+
+// Open-addressing hash map with a flat slot array. Source compatible with the
+// commonly used part of std::unordered_map; the differences are that any
+// insertion may invalidate iterators and references (elements are stored
+// inline and move on rehash), and there is no bucket interface.
+template <class K, class V, class Hash = shm::hash<K>, class Eq = std::equal_to<K>,
+          class Alloc = std::allocator<std::pair<const K, V>>>
+class super_hashmap : public detail::raw_hash_table<detail::map_policy<K, V>, Hash, Eq, Alloc> {
+    using base = detail::raw_hash_table<detail::map_policy<K, V>, Hash, Eq, Alloc>;
+    template <class Key>
+    using key_arg = typename base::template key_arg<Key>;
+
+public:
+    using mapped_type = V;
+    using typename base::const_iterator;
+    using typename base::iterator;
+    using typename base::key_type;
+    using typename base::size_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    super_hashmap& operator=(std::initializer_list<value_type> init) {
+        base::operator=(init);
+        return *this;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return this->emplace_with_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                      std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+        return this->emplace_with_key(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                      std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <class... Args>
+    iterator try_emplace(const_iterator, const key_type& key, Args&&... args) {
+        return try_emplace(key, std::forward<Args>(args)...).first;
+    }
+
+    template <class... Args>
+    iterator try_emplace(const_iterator, key_type&& key, Args&&... args) {
+        return try_emplace(std::move(key), std::forward<Args>(args)...).first;
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+        auto res = try_emplace(key, std::forward<M>(obj));
+        if (!res.second) res.first->second = std::forward<M>(obj);
+        return res;
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+        auto res = try_emplace(std::move(key), std::forward<M>(obj));
+        if (!res.second) res.first->second = std::forward<M>(obj);
+        return res;
+    }
+
+    template <class M>
+    iterator insert_or_assign(const_iterator, const key_type& key, M&& obj) {
+        return insert_or_assign(key, std::forward<M>(obj)).first;
+    }
+
+    template <class M>
+    iterator insert_or_assign(const_iterator, key_type&& key, M&& obj) {
+        return insert_or_assign(std::move(key), std::forward<M>(obj)).first;
+    }
+
+    V& operator[](const key_type& key) { return try_emplace(key).first->second; }
+    V& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+
+    template <class Key = key_type>
+    V& at(const key_arg<Key>& key) {
+        auto it = this->template find<Key>(key);
+        if (it == this->end()) throw std::out_of_range("shm::super_hashmap::at: key not found");
+        return it->second;
+    }
+
+    template <class Key = key_type>
+    const V& at(const key_arg<Key>& key) const {
+        return const_cast<super_hashmap*>(this)->template at<Key>(key);
+    }
+};
+
+template <class K, class V, class Hash, class Eq, class Alloc, class Pred>
+typename super_hashmap<K, V, Hash, Eq, Alloc>::size_type erase_if(super_hashmap<K, V, Hash, Eq, Alloc>& map,
+                                                                  Pred pred) {
+    const auto old_size = map.size();
+    for (auto it = map.begin(); it != map.end();) {
+        if (pred(*it)) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return old_size - map.size();
+}
+
+namespace pmr {
+
+template <class K, class V, class Hash = shm::hash<K>, class Eq = std::equal_to<K>>
+using super_hashmap = shm::super_hashmap<K, V, Hash, Eq, std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+
+}  // namespace pmr
+
+}  // namespace shm
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "shm/detail/raw_hash_table.hpp"
+#include "shm/hash.hpp"
+
+namespace shm {
+
+namespace detail {
+
+template <class K>
+struct set_policy {
+    using key_type = K;
+    using value_type = K;
+    using slot_type = K;
+    static constexpr bool constant_iterators = true;
+
+    static const K& key(const slot_type& slot) noexcept { return slot; }
+    static value_type& element(slot_type* slot) noexcept { return *slot; }
+
+    template <class Alloc>
+    static void transfer(Alloc& alloc, slot_type* dst, slot_type* src) {
+        std::allocator_traits<Alloc>::construct(alloc, dst, std::move(*src));
+        std::allocator_traits<Alloc>::destroy(alloc, src);
+    }
+
+    // emplace() skips building a temporary when handed a key.
+    template <class... Args>
+    static constexpr bool key_extractable = [] {
+        if constexpr (sizeof...(Args) == 1) {
+            return std::is_same_v<std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Args...>>>, K>;
+        } else {
+            return false;
+        }
+    }();
+
+    static const K& extract_key(const K& key) noexcept { return key; }
+};
+
+}  // namespace detail
+
+// Open-addressing hash set on the same table as super_hashmap, with the
+// same differences from std::unordered_set. Elements are reachable only
+// as const, through iterator and const_iterator alike.
+template <class K, class Hash = shm::hash<K>, class Eq = std::equal_to<K>, class Alloc = std::allocator<K>>
+class super_hashset : public detail::raw_hash_table<detail::set_policy<K>, Hash, Eq, Alloc> {
+    using base = detail::raw_hash_table<detail::set_policy<K>, Hash, Eq, Alloc>;
+
+public:
+    using typename base::const_iterator;
+    using typename base::iterator;
+    using typename base::key_type;
+    using typename base::size_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    super_hashset& operator=(std::initializer_list<value_type> init) {
+        base::operator=(init);
+        return *this;
+    }
+};
+
+template <class K, class Hash, class Eq, class Alloc, class Pred>
+typename super_hashset<K, Hash, Eq, Alloc>::size_type erase_if(super_hashset<K, Hash, Eq, Alloc>& set, Pred pred) {
+    const auto old_size = set.size();
+    for (auto it = set.begin(); it != set.end();) {
+        if (pred(*it)) {
+            it = set.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return old_size - set.size();
+}
+
+namespace pmr {
+
+template <class K, class Hash = shm::hash<K>, class Eq = std::equal_to<K>>
+using super_hashset = shm::super_hashset<K, Hash, Eq, std::pmr::polymorphic_allocator<K>>;
+
+}  // namespace pmr
+
+}  // namespace shm
@@ -0,0 +1,71 @@
+#pragma once
+
+// Minimal unit-test harness. Each case registers itself with SHM_TEST;
+// CHECK records a failure and carries on, REQUIRE abandons the case. The
+// runner prints one line per case and writes the same report to
+// test_output.txt in the source tree by default.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace shm::test {
+
+struct failure {
+    const char* file;
+    int line;
+    std::string message;
+};
+
+// Failures of the case currently running.
+std::vector<failure>& failures();
+
+// Thrown by REQUIRE to end a case early.
+struct abort_case {};
+
+using case_fn = void (*)();
+
+struct registrar {
+    registrar(const char* name, case_fn fn);
+};
+
+struct test_case {
+    const char* name;
+    case_fn fn;
+};
+
+std::vector<test_case>& cases();
+
+inline bool record(bool ok, const char* file, int line, const char* expr) {
+    if (!ok) failures().push_back({file, line, expr});
+    return ok;
+}
+
+}  // namespace shm::test
+
+#define SHM_TEST_CONCAT_(a, b) a##b
+#define SHM_TEST_CONCAT(a, b) SHM_TEST_CONCAT_(a, b)
+#define SHM_TEST(name)                                                                                 \
+    static void SHM_TEST_CONCAT(shm_test_fn_, __LINE__)();                                             \
+    static ::shm::test::registrar SHM_TEST_CONCAT(shm_test_reg_, __LINE__)(name,                       \
+                                                                           SHM_TEST_CONCAT(shm_test_fn_, __LINE__)); \
+    static void SHM_TEST_CONCAT(shm_test_fn_, __LINE__)()
+
+#define CHECK(expr) ::shm::test::record(static_cast<bool>(expr), __FILE__, __LINE__, #expr)
+
+#define REQUIRE(expr)                                                              \
+    do {                                                                           \
+        if (!::shm::test::record(static_cast<bool>(expr), __FILE__, __LINE__, #expr)) \
+            throw ::shm::test::abort_case{};                                       \
+    } while (0)
+
+#define CHECK_THROWS(expr, type)                                                              \
+    do {                                                                                      \
+        bool shm_thrown = false;                                                              \
+        try {                                                                                 \
+            (void)(expr);                                                                     \
+        } catch (const type&) {                                                               \
+            shm_thrown = true;                                                                \
+        }                                                                                     \
+        ::shm::test::record(shm_thrown, __FILE__, __LINE__, #expr " throws " #type);          \
+    } while (0)
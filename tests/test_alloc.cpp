@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+
+#include "shm/arena.hpp"
+#include "shm/sentinel_hashmap.hpp"
+#include "shm/super_hashmap.hpp"
+#include "test.hpp"
+
+static_assert(shm::detail::trivially_destroyed<shm::arena_allocator<std::pair<const int, int>>, std::pair<const int, int>>);
+static_assert(shm::detail::trivially_destroyed<std::pmr::polymorphic_allocator<std::pair<const int, int>>,
+                                               std::pair<const int, int>>);
+static_assert(!shm::detail::trivially_destroyed<std::allocator<std::string>, std::string>);
+
+namespace {
+
+using arena_map = shm::super_hashmap<std::uint64_t, std::uint32_t, shm::hash<std::uint64_t>, std::equal_to<std::uint64_t>,
+                                     shm::arena_allocator<std::pair<const std::uint64_t, std::uint32_t>>>;
+
+// Counts the bytes it has outstanding, to catch buffers that are never
+// given back.
+class counting_resource final : public std::pmr::memory_resource {
+public:
+    std::size_t outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        void* p = std::pmr::new_delete_resource()->allocate(bytes, align);
+        outstanding += bytes;
+        return p;
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// Move assignment between tables on different resources copies the
+// elements and must give the target's old arrays back to its resource.
+template <class Table>
+void move_between_resources(std::uint32_t target_size, std::uint32_t source_size) {
+    counting_resource a;
+    counting_resource b;
+    {
+        Table target(&a);
+        for (std::uint32_t i = 0; i != target_size; ++i) target[i] = i;
+        Table source(&b);
+        for (std::uint32_t i = 0; i != source_size; ++i) source[i + 1000] = i;
+        target = std::move(source);
+        CHECK(target.size() == source_size && source.empty());
+        for (std::uint32_t i = 0; i != source_size; ++i) CHECK(target.at(i + 1000) == i);
+        CHECK(!target.contains(1));
+        CHECK(target.get_allocator().resource() == &a);
+        // The growth budget must match the new contents.
+        for (std::uint32_t i = 0; i != 3000; ++i) target[i + 5000] = i;
+        CHECK(target.size() == source_size + 3000);
+    }
+    CHECK(a.outstanding == 0);
+    CHECK(b.outstanding == 0);
+}
+
+}  // namespace
+
+SHM_TEST("alloc/arena") {
+    alignas(64) char buffer[1024];
+    for (int round = 0; round != 3; ++round) {
+        shm::arena a(buffer, sizeof buffer);
+        {
+            arena_map m(a);
+            m.set_incremental_resize(static_cast<std::size_t>(round) * 4);
+            for (std::uint32_t i = 0; i != 20000; ++i) m[i * 7ULL] = i;
+            for (std::uint32_t i = 0; i != 20000; ++i) REQUIRE(m.at(i * 7ULL) == i);
+            arena_map copy(m);
+            CHECK(copy == m);
+            arena_map moved(std::move(copy));
+            CHECK(moved == m);
+            shm::arena other;
+            arena_map elsewhere(m, shm::arena_allocator<std::pair<const std::uint64_t, std::uint32_t>>(other));
+            CHECK(elsewhere == m);
+            elsewhere = std::move(moved);
+            CHECK(elsewhere == m);
+        }
+        if (round == 1) {
+            a.reset();
+        } else {
+            a.release();
+        }
+        arena_map m(a);
+        for (std::uint32_t i = 0; i != 5000; ++i) m[i] = 1;
+        CHECK(m.size() == 5000);
+    }
+}
+
+SHM_TEST("alloc/pmr") {
+    std::pmr::monotonic_buffer_resource mr;
+    shm::pmr::super_hashmap<std::pmr::string, std::pmr::string> m(&mr);
+    for (int i = 0; i != 2000; ++i) {
+        m.try_emplace(std::pmr::string(std::to_string(i) + " padded out past the small string buffer"),
+                      "a value long enough to need its own allocation");
+    }
+    CHECK(m.size() == 2000);
+    CHECK(m.begin()->first.get_allocator().resource() == &mr);
+    CHECK(m.begin()->second.get_allocator().resource() == &mr);
+
+    shm::arena a;
+    shm::pmr::super_hashmap<int, int> on_arena(&a);
+    for (int i = 0; i != 1000; ++i) on_arena[i] = i;
+    CHECK(on_arena.size() == 1000 && on_arena.at(999) == 999);
+}
+
+SHM_TEST("alloc/move_between_resources") {
+    using sentinel_map = shm::sentinel_hashmap<std::uint32_t, std::uint32_t, shm::hash<std::uint32_t>,
+                                               std::pmr::polymorphic_allocator<std::pair<const std::uint32_t, std::uint32_t>>>;
+    move_between_resources<sentinel_map>(100, 50);
+    move_between_resources<sentinel_map>(100, 0);
+    move_between_resources<sentinel_map>(0, 50);
+    move_between_resources<shm::pmr::super_hashmap<std::uint32_t, std::uint32_t>>(100, 50);
+    move_between_resources<shm::pmr::super_hashmap<std::uint32_t, std::uint32_t>>(100, 0);
+}
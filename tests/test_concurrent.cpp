@@ -0,0 +1,193 @@
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shm/concurrent_super_hashmap.hpp"
+#include "test.hpp"
+
+SHM_TEST("concurrent/readers_and_writers") {
+    shm::concurrent_super_hashmap<long, long> m(16);
+    static_assert(decltype(m)::lock_free_reads);
+    std::atomic<bool> stop{false};
+    std::atomic<long> wrong{0};
+    std::vector<std::thread> threads;
+    for (long w = 0; w != 3; ++w) {
+        threads.emplace_back([&, w] {
+            for (long i = 0; i != 30000; ++i) {
+                const long k = i * 3 + w;
+                m.try_emplace(k, k * 2);
+                if (i % 3 == 0) {
+                    m.erase(k);
+                } else if (i % 5 == 0) {
+                    m.insert_or_assign(k, k * 2);
+                }
+            }
+        });
+    }
+    for (int r = 0; r != 2; ++r) {
+        threads.emplace_back([&] {
+            while (!stop) {
+                for (long k = 0; k < 90000; k += 7) {
+                    long v;
+                    if (m.find(k, v) && v != 2 * k) ++wrong;
+                }
+            }
+        });
+    }
+    for (int w = 0; w != 3; ++w) threads[w].join();
+    stop = true;
+    for (std::size_t i = 3; i != threads.size(); ++i) threads[i].join();
+
+    CHECK(wrong == 0);
+    std::size_t n = 0;
+    m.for_each([&](long k, long v) {
+        CHECK(v == 2 * k);
+        ++n;
+    });
+    CHECK(n == m.size());
+    for (long i = 0; i != 30000; ++i) {
+        for (long w = 0; w != 3; ++w) REQUIRE(m.contains(i * 3 + w) == (i % 3 != 0));
+    }
+    m.reclaim();
+    m.clear();
+    CHECK(m.empty());
+}
+
+SHM_TEST("concurrent/locked_readers") {
+    shm::concurrent_super_hashmap<std::string, std::string> m;
+    static_assert(!decltype(m)::lock_free_reads);
+    static_assert(decltype(m)::lock_free_misses);
+    std::vector<std::thread> threads;
+    std::atomic<long> wrong{0};
+    for (int w = 0; w != 4; ++w) {
+        threads.emplace_back([&, w] {
+            for (int i = 0; i != 5000; ++i) {
+                const auto k = std::to_string(i * 4 + w);
+                m.try_emplace(k, k + "v");
+                const auto got = m.get(k);
+                if (!got || *got != k + "v") ++wrong;
+                m.modify(k, [](std::string& v) { v += "!"; });
+                if (i % 2) m.erase(k);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    CHECK(wrong == 0);
+    CHECK(m.size() == 10000);
+    m.reserve(100000);
+    CHECK(m.size() == 10000);
+    CHECK(m.get("0").value_or("") == "0v!");
+}
+
+SHM_TEST("concurrent/churn_memory_is_bounded") {
+    // A fixed number of live keys under erase/insert churn: tombstones must
+    // be purged without retiring a table each time, while a reader keeps
+    // probing the shard being purged.
+    shm::concurrent_super_hashmap<std::uint64_t, std::uint64_t> m(1);
+    std::uint64_t next = 0;
+    for (; next != 1000; ++next) m.try_emplace(next, next);
+    const auto before = m.memory_usage();
+
+    std::atomic<bool> stop{false};
+    std::atomic<long> wrong{0};
+    std::thread reader([&] {
+        for (std::uint64_t k = 0; !stop; k = (k + 7) % 400000) {
+            std::uint64_t v;
+            if (m.find(k, v) && v != k) ++wrong;
+        }
+    });
+    for (int i = 0; i != 300000; ++i, ++next) {
+        REQUIRE(m.erase(next - 1000) == 1);
+        m.try_emplace(next, next);
+    }
+    stop = true;
+    reader.join();
+
+    CHECK(wrong == 0);
+    CHECK(m.memory_usage() == before);
+    CHECK(m.size() == 1000);
+    for (std::uint64_t k = next - 1000; k != next; ++k) REQUIRE(m.get(k) == k);
+}
+
+SHM_TEST("concurrent/string_churn_with_optimistic_misses") {
+    // As above with keys that are not trivially copyable: tombstones are
+    // purged in place by moving strings around while a reader probes the
+    // control bytes for misses and locks for hits.
+    shm::concurrent_super_hashmap<std::string, std::uint64_t> m(1);
+    std::uint64_t next = 0;
+    for (; next != 1000; ++next) m.try_emplace(std::to_string(next), next);
+    const auto before = m.memory_usage();
+
+    std::atomic<bool> stop{false};
+    std::atomic<long> wrong{0};
+    std::thread reader([&] {
+        for (std::uint64_t k = 0; !stop; k = (k + 7) % 200000) {
+            std::uint64_t v;
+            if (m.find(std::to_string(k), v) && v != k) ++wrong;
+        }
+    });
+    for (int i = 0; i != 100000; ++i, ++next) {
+        REQUIRE(m.erase(std::to_string(next - 1000)) == 1);
+        m.try_emplace(std::to_string(next), next);
+    }
+    stop = true;
+    reader.join();
+
+    CHECK(wrong == 0);
+    CHECK(m.memory_usage() == before);
+    CHECK(m.size() == 1000);
+    for (std::uint64_t k = next - 1000; k != next; ++k) REQUIRE(m.get(std::to_string(k)) == k);
+    CHECK(!m.contains(std::to_string(next)));
+}
+
+namespace {
+
+// Copying and moving may throw: after transfers_left more of either, the
+// next one does. Growth has to copy such elements to keep the old table
+// intact if that happens.
+struct throwing_copy {
+    static inline int transfers_left = -1;
+
+    long value;
+
+    explicit throwing_copy(long v) : value(v) {}
+    throwing_copy(const throwing_copy& other) : value(other.value) { count(); }
+    throwing_copy(throwing_copy&& other) noexcept(false) : value(other.value) {
+        count();
+        other.value = -1;
+    }
+    throwing_copy& operator=(const throwing_copy&) = default;
+
+    static void count() {
+        if (transfers_left == 0) throw std::runtime_error("transfer");
+        if (transfers_left > 0) --transfers_left;
+    }
+};
+
+}  // namespace
+
+SHM_TEST("concurrent/failed_growth_keeps_elements") {
+    shm::concurrent_super_hashmap<long, throwing_copy> m(1);
+    static_assert(!decltype(m)::lock_free_misses);
+    long n = 0;
+    bool threw = false;
+    for (; n != 1000 && !threw; ++n) {
+        throwing_copy::transfers_left = 3;
+        try {
+            m.try_emplace(n, n);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+    }
+    throwing_copy::transfers_left = -1;
+    REQUIRE(threw);
+    CHECK(m.size() == static_cast<std::size_t>(n - 1));
+    for (long k = 0; k != n - 1; ++k) {
+        long v = -2;
+        REQUIRE(m.visit(k, [&](const throwing_copy& x) { v = x.value; }));
+        CHECK(v == k);
+    }
+}
@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "shm/hash.hpp"
+#include "shm/super_hashmap.hpp"
+#include "test.hpp"
+
+static_assert(shm::detail::is_avalanching<shm::hash<int>>::value);
+static_assert(!shm::detail::is_avalanching<std::hash<int>>::value);
+
+SHM_TEST("hash/seeding") {
+    const shm::hash<std::uint64_t> a, b;
+    CHECK(a.seed() != b.seed());
+    const shm::hash<std::uint64_t> c(42), d(42);
+    CHECK(c(12345) == d(12345));
+    CHECK(c.seed() == 42);
+
+    // The seed is kept by copies, so a copied table still finds its keys.
+    shm::super_hashmap<std::uint64_t, int> m;
+    for (int i = 0; i != 1000; ++i) m[static_cast<std::uint64_t>(i)] = i;
+    const auto copy = m;
+    CHECK(copy.hash_function().seed() == m.hash_function().seed());
+    CHECK(copy == m);
+}
+
+SHM_TEST("hash/types") {
+    const shm::hash<double> hd(1);
+    CHECK(hd(0.0) == hd(-0.0));
+    CHECK(hd(1.0) != hd(2.0));
+
+    const shm::hash<std::string> hs(5);
+    const shm::hash<std::string_view> hv(5);
+    CHECK(hs(std::string("hello")) == hv("hello"));
+
+    // Every length through the byte hash, distinct inputs, distinct hashes.
+    std::string text;
+    std::set<std::size_t> seen;
+    for (int len = 0; len != 200; ++len) {
+        seen.insert(hv(text));
+        text.push_back(static_cast<char>('a' + len % 26));
+    }
+    CHECK(seen.size() == 200);
+
+    const shm::hash<int*> hp(3);
+    int x = 0, y = 0;
+    CHECK(hp(&x) != hp(&y));
+}
+
+SHM_TEST("hash/weak_hash_is_mixed") {
+    // Identity hashes of strided keys would share their low bits; mixing
+    // keeps the probes short anyway.
+    shm::super_hashmap<std::uint64_t, int, std::hash<std::uint64_t>> m;
+    for (std::uint64_t i = 0; i != 20000; ++i) m[i << 20] = 0;
+    CHECK(m.stats().max_displacement <= 4);
+}
@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "test.hpp"
+
+#ifndef SHM_TEST_OUTPUT
+#define SHM_TEST_OUTPUT "test_output.txt"
+#endif
+
+namespace shm::test {
+
+std::vector<failure>& failures() {
+    static std::vector<failure> all;
+    return all;
+}
+
+registrar::registrar(const char* name, case_fn fn) { cases().push_back({name, fn}); }
+
+std::vector<test_case>& cases() {
+    static std::vector<test_case> all;
+    return all;
+}
+
+}  // namespace shm::test
+
+namespace {
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--filter=SUBSTR] [--out=PATH]\n"
+                 "  --filter      run only cases whose name contains SUBSTR\n"
+                 "  --out         report file (default " SHM_TEST_OUTPUT ")\n",
+                 argv0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string out_path = SHM_TEST_OUTPUT;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(9);
+        } else if (arg.rfind("--out=", 0) == 0) {
+            out_path = arg.substr(6);
+        } else {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    std::FILE* out = std::fopen(out_path.c_str(), "w");
+    if (!out) {
+        std::perror(out_path.c_str());
+        return 1;
+    }
+
+    const auto emit = [&](const std::string& line) {
+        std::printf("%s\n", line.c_str());
+        std::fprintf(out, "%s\n", line.c_str());
+    };
+
+    std::size_t run = 0, failed = 0;
+    for (const auto& c : shm::test::cases()) {
+        if (!filter.empty() && std::string(c.name).find(filter) == std::string::npos) continue;
+        auto& failures = shm::test::failures();
+        failures.clear();
+        try {
+            c.fn();
+        } catch (const shm::test::abort_case&) {
+        } catch (const std::exception& e) {
+            failures.push_back({"", 0, std::string("unexpected exception: ") + e.what()});
+        } catch (...) {
+            failures.push_back({"", 0, "unexpected exception"});
+        }
+        ++run;
+        if (failures.empty()) {
+            emit(std::string("PASS ") + c.name);
+            continue;
+        }
+        ++failed;
+        emit(std::string("FAIL ") + c.name);
+        for (const auto& f : failures) {
+            emit(std::string("    ") + (f.line ? std::string(f.file) + ":" + std::to_string(f.line) + ": " : "") +
+                 f.message);
+        }
+    }
+    emit(std::to_string(run - failed) + "/" + std::to_string(run) + " passed");
+    std::fclose(out);
+    return failed ? 1 : 0;
+}
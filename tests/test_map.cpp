@@ -0,0 +1,287 @@
+#include <iterator>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "shm/super_hashmap.hpp"
+#include "test.hpp"
+
+namespace {
+
+// Throws from its constructor when asked to, to check that a failed
+// insertion leaves the table as it was.
+struct fragile {
+    int value;
+    explicit fragile(int v) : value(v) {
+        if (v < 0) throw std::runtime_error("fragile");
+    }
+};
+
+// Every key in one of a handful of buckets, so probes run long. The
+// hasher vouches for itself, which keeps the table from mixing it.
+struct clumping_hash {
+    using is_avalanching = void;
+    std::size_t operator()(std::uint64_t k) const noexcept { return (k % 7) * 0x9E3779B97F4A7C15ULL; }
+};
+
+template <class Map>
+bool same_contents(const Map& map, const std::unordered_map<std::uint64_t, std::uint64_t>& ref) {
+    if (map.size() != ref.size()) return false;
+    std::size_t seen = 0;
+    for (const auto& [k, v] : map) {
+        const auto it = ref.find(k);
+        if (it == ref.end() || it->second != v) return false;
+        ++seen;
+    }
+    return seen == ref.size();
+}
+
+// Random operations against std::unordered_map, comparing results as they
+// go and the full contents every few hundred steps.
+template <class Map>
+void differential(Map& map, std::uint64_t seed, std::uint64_t key_range, std::size_t steps) {
+    std::unordered_map<std::uint64_t, std::uint64_t> ref;
+    std::mt19937_64 rng(seed);
+    for (std::size_t step = 0; step != steps; ++step) {
+        const std::uint64_t k = rng() % key_range;
+        switch (rng() % 8) {
+            case 0:
+            case 1:
+                CHECK(map.try_emplace(k, step).second == ref.try_emplace(k, step).second);
+                break;
+            case 2:
+                CHECK(map.insert_or_assign(k, step).second == ref.insert_or_assign(k, step).second);
+                break;
+            case 3:
+                CHECK(map.erase(k) == ref.erase(k));
+                break;
+            case 4:
+                if (auto it = map.find(k); it != map.end()) {
+                    map.erase(it);
+                    ref.erase(k);
+                }
+                break;
+            case 5:
+                map[k] += 1;
+                ref[k] += 1;
+                break;
+            default: {
+                const auto it = map.find(k);
+                const auto r = ref.find(k);
+                REQUIRE((it == map.end()) == (r == ref.end()));
+                if (r != ref.end()) CHECK(it->second == r->second);
+            }
+        }
+        REQUIRE(map.size() == ref.size());
+        if (step % 499 == 0) REQUIRE(same_contents(map, ref));
+    }
+    REQUIRE(same_contents(map, ref));
+}
+
+}  // namespace
+
+SHM_TEST("map/basic") {
+    shm::super_hashmap<std::string, int> m{{"one", 1}, {"two", 2}};
+    CHECK(m.size() == 2);
+    CHECK(m.at("one") == 1);
+    CHECK_THROWS(m.at("three"), std::out_of_range);
+
+    CHECK(m.emplace("three", 3).second);
+    CHECK(!m.emplace("three", 4).second);
+    CHECK(m["three"] == 3);
+    CHECK(m.insert({"four", 4}).second);
+    CHECK(!m.try_emplace("four", 5).second);
+    CHECK(!m.insert_or_assign("four", 40).second);
+    CHECK(m.at("four") == 40);
+    m["five"];
+    CHECK(m.contains("five") && m.at("five") == 0);
+    CHECK(m.count("six") == 0);
+
+    const auto [first, last] = m.equal_range("two");
+    CHECK(first != last && first->second == 2 && std::next(first) == last);
+    CHECK(m.erase("two") == 1);
+    CHECK(m.erase("two") == 0);
+    CHECK(m.size() == 4);
+
+    m.clear();
+    CHECK(m.empty() && m.begin() == m.end());
+    m["again"] = 1;
+    CHECK(m.size() == 1);
+}
+
+SHM_TEST("map/differential") {
+    shm::super_hashmap<std::uint64_t, std::uint64_t> small;
+    differential(small, 1, 64, 20000);
+    shm::super_hashmap<std::uint64_t, std::uint64_t> wide;
+    differential(wide, 2, 20000, 60000);
+    shm::super_hashmap<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>> weak;
+    differential(weak, 3, 5000, 30000);
+    shm::super_hashmap<std::uint64_t, std::uint64_t, clumping_hash> clumped;
+    differential(clumped, 4, 600, 20000);
+}
+
+SHM_TEST("map/incremental_resize") {
+    shm::super_hashmap<std::uint64_t, std::uint64_t> m;
+    m.set_incremental_resize(8);
+    CHECK(m.incremental_resize() == 8);
+    bool seen_resizing = false;
+    for (std::uint64_t i = 0; i != 50000; ++i) {
+        m.emplace(i, i);
+        if (m.resizing()) {
+            seen_resizing = true;
+            // Lookups and iteration see both arrays mid-resize.
+            REQUIRE(m.contains(i / 2) && m.contains(i));
+        }
+    }
+    CHECK(seen_resizing);
+    std::size_t n = 0;
+    for (const auto& kv : m) n += kv.first == kv.second;
+    CHECK(n == m.size());
+    for (std::uint64_t i = 0; i < 50000; i += 3) CHECK(m.erase(i) == 1);
+    m.finish_resize();
+    CHECK(!m.resizing());
+
+    shm::super_hashmap<std::uint64_t, std::uint64_t> plain;
+    differential(plain, 5, 30000, 40000);
+    shm::super_hashmap<std::uint64_t, std::uint64_t> stepped;
+    stepped.set_incremental_resize(4);
+    differential(stepped, 5, 30000, 40000);
+    CHECK(plain == stepped);
+}
+
+SHM_TEST("map/copy_move_swap") {
+    shm::super_hashmap<std::string, std::string> a;
+    for (int i = 0; i != 1000; ++i) a.emplace(std::to_string(i), std::string(i % 40, 'x'));
+    shm::super_hashmap<std::string, std::string> b(a);
+    CHECK(a == b);
+    b["extra"] = "y";
+    CHECK(a != b);
+    shm::super_hashmap<std::string, std::string> c(std::move(b));
+    CHECK(c.size() == 1001 && c.at("extra") == "y");
+    b = c;
+    CHECK(b == c);
+    a.swap(b);
+    CHECK(a.size() == 1001 && b.size() == 1000);
+    a = std::move(b);
+    CHECK(a.size() == 1000 && !a.contains("extra"));
+    shm::super_hashmap<std::string, std::string> d(a, std::allocator<std::pair<const std::string, std::string>>());
+    CHECK(d == a);
+    a = {{"k", "v"}};
+    CHECK(a.size() == 1 && a.at("k") == "v");
+}
+
+SHM_TEST("map/erase_while_iterating") {
+    shm::super_hashmap<int, int> m;
+    for (int i = 0; i != 5000; ++i) m[i] = i;
+    for (auto it = m.begin(); it != m.end();) {
+        if (it->first % 2) {
+            it = m.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    CHECK(m.size() == 2500);
+    CHECK(erase_if(m, [](const auto& kv) { return kv.first % 4 == 0; }) == 1250);
+    for (const auto& [k, v] : m) CHECK(k % 4 == 2 && k == v);
+}
+
+SHM_TEST("map/transparent_lookup") {
+    shm::super_hashmap<std::string, int, shm::hash<std::string>, std::equal_to<>> m;
+    for (int i = 0; i != 1000; ++i) m[std::to_string(i)] = i;
+    CHECK(m.find(std::string_view("123"))->second == 123);
+    CHECK(m.contains("999") && !m.contains("1000"));
+    CHECK(m.at(std::string_view("7")) == 7);
+    CHECK(m.erase(std::string_view("7")) == 1);
+
+    shm::super_hashmap<std::string, int, shm::string_hash, std::equal_to<>> u{{"a", 1}};
+    CHECK(u.contains(std::string_view("a")));
+}
+
+SHM_TEST("map/rehash_and_reserve") {
+    shm::super_hashmap<int, int> m;
+    m.reserve(1000);
+    const auto buckets = m.bucket_count();
+    for (int i = 0; i != 1000; ++i) m[i] = i;
+    CHECK(m.bucket_count() == buckets);
+    for (int i = 0; i != 990; ++i) m.erase(i);
+    m.rehash(0);
+    CHECK(m.bucket_count() < buckets);
+    for (int i = 990; i != 1000; ++i) CHECK(m.at(i) == i);
+    m.rehash(100000);
+    CHECK(m.bucket_count() >= 100000 && m.size() == 10);
+    CHECK(m.load_factor() > 0 && m.load_factor() <= m.max_load_factor());
+}
+
+SHM_TEST("map/tombstones_stay_bounded") {
+    // Steady churn at a fixed size must neither grow the table nor let
+    // tombstones pile up.
+    shm::super_hashmap<std::uint64_t, std::uint64_t> m;
+    std::mt19937_64 rng(6);
+    std::vector<std::uint64_t> live;
+    for (int i = 0; i != 4000; ++i) {
+        live.push_back(rng());
+        m.emplace(live.back(), 0);
+    }
+    const auto capacity = m.bucket_count();
+    for (int i = 0; i != 200000; ++i) {
+        auto& k = live[rng() % live.size()];
+        REQUIRE(m.erase(k) == 1);
+        k = rng();
+        m.emplace(k, 0);
+        if (i % 997 == 0) REQUIRE(m.stats().tombstones <= capacity / 8 + 1);
+    }
+    CHECK(m.bucket_count() == capacity);
+    for (auto k : live) CHECK(m.contains(k));
+
+    // Erasing from a sparse table never needs a tombstone.
+    shm::super_hashmap<int, int> sparse;
+    for (int i = 0; i != 100; ++i) sparse[i] = i;
+    sparse.reserve(10000);
+    for (int i = 0; i != 100; i += 2) sparse.erase(i);
+    CHECK(sparse.stats().tombstones == 0);
+}
+
+SHM_TEST("map/batch_lookup") {
+    shm::super_hashmap<std::uint64_t, std::uint64_t> m;
+    for (std::uint64_t i = 0; i != 10000; ++i) m[i * 3] = i;
+    std::vector<std::uint64_t> keys(300);
+    for (std::size_t i = 0; i != keys.size(); ++i) keys[i] = i * 5;
+    std::vector<decltype(m)::iterator> found(keys.size());
+    m.find_batch(keys, found);
+    std::unique_ptr<bool[]> present(new bool[keys.size()]);
+    const std::size_t hits = m.contains_batch(keys, std::span(present.get(), keys.size()));
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i != keys.size(); ++i) {
+        CHECK(found[i] == m.find(keys[i]));
+        CHECK(present[i] == m.contains(keys[i]));
+        expected += present[i];
+    }
+    CHECK(hits == expected);
+}
+
+SHM_TEST("map/exception_safety") {
+    shm::super_hashmap<int, fragile> m;
+    for (int i = 0; i != 100; ++i) m.try_emplace(i, i);
+    CHECK_THROWS(m.try_emplace(1000, -1), std::runtime_error);
+    CHECK(m.size() == 100 && !m.contains(1000));
+    for (int i = 0; i != 100; ++i) CHECK(m.at(i).value == i);
+    // An existing key is not reconstructed, so nothing throws.
+    CHECK(!m.try_emplace(5, -1).second);
+}
+
+SHM_TEST("map/stats") {
+    shm::super_hashmap<int, int> m;
+    for (int i = 0; i != 1000; ++i) m[i] = i;
+    const shm::table_stats s = m.stats();
+    CHECK(s.size == 1000);
+    CHECK(s.capacity == m.bucket_count());
+    CHECK(s.tombstones == 0);
+    CHECK(s.mean_displacement <= static_cast<double>(s.max_displacement));
+    CHECK(!m.debug_stats().empty());
+    CHECK(m.memory_usage() >= m.bucket_count() * sizeof(std::pair<const int, int>));
+}
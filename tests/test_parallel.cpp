@@ -0,0 +1,74 @@
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "shm/super_hashmap.hpp"
+#include "shm/super_hashset.hpp"
+#include "test.hpp"
+
+SHM_TEST("parallel/build") {
+    for (unsigned threads : {1u, 2u, 3u, 8u}) {
+        for (std::size_t n : {0u, 1u, 1000u, 60000u}) {
+            // Many duplicate keys: the first of each must win, as with insert().
+            std::mt19937_64 rng(n + threads);
+            std::vector<std::pair<std::uint64_t, std::size_t>> rows;
+            for (std::size_t i = 0; i != n; ++i) rows.emplace_back(rng() % (n / 2 + 1), i);
+            std::unordered_map<std::uint64_t, std::size_t> ref;
+            for (const auto& r : rows) ref.insert(r);
+
+            shm::super_hashmap<std::uint64_t, std::size_t> m(shm::parallel_build, rows, threads);
+            REQUIRE(m.size() == ref.size());
+            for (const auto& [k, v] : ref) REQUIRE(m.at(k) == v);
+            std::size_t seen = 0;
+            for (const auto& kv : m) seen += ref.count(kv.first);
+            CHECK(seen == ref.size());
+            m.emplace(~std::uint64_t{0}, 0);
+            CHECK(m.size() == ref.size() + 1);
+        }
+    }
+
+    std::vector<std::string> words;
+    for (int i = 0; i != 30000; ++i) words.push_back("w" + std::to_string(i % 20000));
+    shm::super_hashset<std::string> s(shm::parallel_build, words, 4);
+    CHECK(s.size() == 20000);
+    for (int i = 0; i != 20000; ++i) REQUIRE(s.contains("w" + std::to_string(i)));
+}
+
+SHM_TEST("parallel/for_each") {
+    shm::super_hashmap<std::uint64_t, std::uint64_t> m;
+    m.set_incremental_resize(8);
+    std::uint64_t expected = 0;
+    for (std::uint64_t i = 0; i != 100000; ++i) {
+        m[i] = i;
+        expected += i;
+    }
+    for (unsigned threads : {1u, 3u}) {
+        std::atomic<std::uint64_t> sum{0}, count{0};
+        m.parallel_for_each(
+            [&](auto& kv) {
+                kv.second += 1;
+                sum += kv.first;
+                ++count;
+            },
+            threads);
+        CHECK(count == m.size());
+        CHECK(sum == expected);
+    }
+    for (std::uint64_t i = 0; i != 100000; i += 1000) CHECK(m.at(i) == i + 2);
+
+    const auto& cm = m;
+    std::atomic<std::size_t> visited{0};
+    cm.parallel_for_each([&](const auto&) { ++visited; }, 2);
+    CHECK(visited == m.size());
+
+    CHECK_THROWS(m.parallel_for_each(
+                     [](auto& kv) {
+                         if (kv.first == 777) throw std::runtime_error("visitor");
+                     },
+                     4),
+                 std::runtime_error);
+}
@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "shm/compact.hpp"
+#include "shm/sentinel_hashmap.hpp"
+#include "shm/super_hashset.hpp"
+#include "test.hpp"
+
+static_assert(std::is_same_v<shm::compact_hashmap<std::uint32_t, std::uint32_t>,
+                             shm::sentinel_hashmap<std::uint32_t, std::uint32_t>>);
+static_assert(std::is_same_v<shm::compact_hashmap<std::string, int>, shm::super_hashmap<std::string, int>>);
+static_assert(std::is_same_v<shm::compact_hashset<std::string>, shm::super_hashset<std::string>>);
+static_assert(std::is_same_v<decltype(*std::declval<shm::super_hashset<int>&>().begin()), const int&>);
+
+namespace {
+
+// Random operations against std::unordered_map. One key in eight is the
+// table's Empty value, which is kept out of band.
+template <class Map>
+void sentinel_differential(std::uint64_t seed, std::uint64_t key_range, typename Map::key_type empty) {
+    Map m;
+    std::unordered_map<std::uint64_t, std::uint32_t> ref;
+    std::mt19937_64 rng(seed);
+    std::size_t empty_found = 0;
+    for (std::uint32_t step = 0; step != 40000; ++step) {
+        const auto k = rng() % 8 == 0 ? empty : static_cast<typename Map::key_type>(rng() % key_range);
+        switch (rng() % 6) {
+            case 0:
+            case 1:
+                CHECK(m.try_emplace(k, step).second == ref.try_emplace(k, step).second);
+                break;
+            case 2:
+                CHECK(m.erase(k) == ref.erase(k));
+                break;
+            case 3:
+                if (auto it = m.find(k); it != m.end()) {
+                    m.erase(it);
+                    ref.erase(k);
+                }
+                break;
+            default: {
+                const auto it = m.find(k);
+                REQUIRE((it == m.end()) == !ref.count(k));
+                if (it != m.end()) CHECK(it->second == ref[k]);
+                empty_found += it != m.end() && k == empty;
+            }
+        }
+        REQUIRE(m.size() == ref.size());
+    }
+    std::size_t n = 0;
+    for (auto [k, v] : m) {
+        CHECK(ref.at(k) == v);
+        ++n;
+    }
+    CHECK(n == ref.size());
+    CHECK(empty_found > 0);
+    Map copy = m;
+    CHECK(copy == m);
+}
+
+// Too large for the sentinel layout, so compact_hashmap picks super_hashmap.
+struct wide_value {
+    std::uint64_t n;
+    std::uint64_t pad[3] = {};
+};
+
+std::uint64_t value_of(std::uint64_t v) { return v; }
+std::uint64_t value_of(const wide_value& v) { return v.n; }
+
+// The iteration idioms compact.hpp documents as working for both layouts.
+template <class Map>
+void compact_iteration() {
+    using V = typename Map::mapped_type;
+    Map m;
+    for (std::uint64_t k = 0; k != 100; ++k) m.try_emplace(k, V{k});
+    for (auto it = m.begin(); it != m.end(); ++it) it->second = V{it->first * 2};
+    for (auto&& [k, v] : m) v = V{value_of(v) + k};
+    std::uint64_t wrong = 0, n = 0;
+    for (const auto& [k, v] : m) wrong += value_of(v) != k * 3;
+    for (auto [k, v] : m) n += k < 100 && value_of(v) == k * 3;
+    for (auto it = m.cbegin(); it != m.cend(); ++it) wrong += value_of(it->second) != it->first * 3;
+    CHECK(wrong == 0 && n == 100);
+}
+
+}  // namespace
+
+SHM_TEST("set/compact_iteration") {
+    static_assert(std::is_same_v<shm::compact_hashmap<std::uint64_t, std::uint64_t>,
+                                 shm::sentinel_hashmap<std::uint64_t, std::uint64_t>>);
+    static_assert(std::is_same_v<shm::compact_hashmap<std::uint64_t, wide_value>,
+                                 shm::super_hashmap<std::uint64_t, wide_value>>);
+    compact_iteration<shm::compact_hashmap<std::uint64_t, std::uint64_t>>();
+    compact_iteration<shm::compact_hashmap<std::uint64_t, wide_value>>();
+
+    using sentinel_iterator = shm::sentinel_hashmap<std::uint64_t, std::uint64_t>::iterator;
+    static_assert(std::forward_iterator<sentinel_iterator>);
+    static_assert(std::is_same_v<std::iterator_traits<sentinel_iterator>::iterator_category, std::input_iterator_tag>);
+    static_assert(std::is_same_v<std::iterator_traits<shm::sentinel_hashset<int>::iterator>::iterator_category,
+                                 std::forward_iterator_tag>);
+}
+
+SHM_TEST("set/basic") {
+    shm::super_hashset<std::string> s{"a", "b"};
+    CHECK(s.insert("c").second);
+    CHECK(!s.insert("a").second);
+    CHECK(s.emplace("d").second);
+    CHECK(s.emplace(std::string("elephant"), 0, 1).second);
+    CHECK(s.size() == 5 && s.contains("e"));
+    CHECK(s.erase("a") == 1 && !s.contains("a"));
+    shm::super_hashset<std::string> moved(std::move(s), std::allocator<std::string>());
+    CHECK(moved.size() == 4);
+    CHECK(erase_if(moved, [](const std::string& x) { return x.size() == 1; }) == 4);
+    CHECK(moved.empty());
+
+    shm::super_hashset<int> ints;
+    std::unordered_set<int> ref;
+    std::mt19937 rng(7);
+    for (int i = 0; i != 20000; ++i) {
+        const int k = static_cast<int>(rng() % 3000);
+        if (rng() % 3) {
+            CHECK(ints.insert(k).second == ref.insert(k).second);
+        } else {
+            CHECK(ints.erase(k) == ref.erase(k));
+        }
+    }
+    CHECK(ints.size() == ref.size());
+    for (int k : ints) CHECK(ref.count(k) == 1);
+}
+
+SHM_TEST("set/sentinel_tables") {
+    sentinel_differential<shm::sentinel_hashmap<std::uint64_t, std::uint32_t>>(1, 50000, 0);
+    sentinel_differential<shm::sentinel_hashmap<std::uint64_t, std::uint32_t, std::hash<std::uint64_t>,
+                                                std::allocator<std::pair<const std::uint64_t, std::uint32_t>>,
+                                                ~std::uint64_t{0}>>(2, 300, ~std::uint64_t{0});
+    sentinel_differential<shm::sentinel_hashmap<std::uint32_t, std::uint32_t>>(3, 8, 0);
+
+    shm::sentinel_hashset<int> s{0, 1, 2, -1};
+    CHECK(s.size() == 4 && s.contains(0) && s.contains(-1));
+    int sum = 0;
+    for (int x : s) sum += x;
+    CHECK(sum == 2);
+    CHECK(erase_if(s, [](int x) { return x <= 0; }) == 2);
+    CHECK(s.size() == 2);
+
+    shm::sentinel_hashmap<std::uint32_t, std::uint32_t> m;
+    m[0] = 1;
+    // Only the out-of-band key is left, so shrinking frees the arrays.
+    m.rehash(0);
+    CHECK(m.at(0) == 1 && m.size() == 1);
+    CHECK(m.memory_usage() == 0);
+    m[1] = 2;
+    CHECK(m.memory_usage() > 0 && m.at(1) == 2);
+}
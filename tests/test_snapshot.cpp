@@ -0,0 +1,123 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "shm/snapshot.hpp"
+#include "shm/super_hashmap.hpp"
+#include "test.hpp"
+
+#if SHM_SNAPSHOT_HAS_MMAP
+
+namespace {
+
+struct record {
+    double weight;
+    int id;
+};
+
+std::string temp_path(const char* name) { return (std::filesystem::temp_directory_path() / name).string(); }
+
+}  // namespace
+
+SHM_TEST("snapshot/write_and_view") {
+    const std::string path = temp_path("shm_test_records.snap");
+    {
+        shm::snapshot_writer<long, record> out(path, 20000);
+        for (long i = 0; i != 20000; ++i) REQUIRE(out.insert(i * 7, {i * 0.5, static_cast<int>(i)}));
+        CHECK(!out.insert(7, {0, 0}));
+        CHECK_THROWS(
+            [&] {
+                for (long i = 0; i != 20000; ++i) out.insert(-i - 1, {});
+            }(),
+            std::length_error);
+        out.finish();
+    }
+    shm::snapshot_view<long, record> view(path);
+    CHECK(view.size() >= 20000);
+    for (long i = 0; i != 20000; ++i) {
+        const auto it = view.find(i * 7);
+        REQUIRE(it != view.end() && it->second.id == i);
+    }
+    CHECK(!view.contains(3));
+    std::size_t n = 0;
+    for (const auto& e : view) n += e.first % 7 == 0 || e.first < 0;
+    CHECK(n == view.size());
+    std::filesystem::remove(path);
+}
+
+SHM_TEST("snapshot/from_map") {
+    const std::string path = temp_path("shm_test_map.snap");
+    shm::super_hashmap<int, int> m;
+    for (int i = 0; i != 1000; ++i) m[i] = -i;
+    shm::write_snapshot(path, m);
+    {
+        // The map's hash seed travels with the file.
+        shm::snapshot_view<int, int> view(path);
+        for (const auto& [k, v] : m) REQUIRE(view.at(k) == v);
+        const auto moved = std::move(view);
+        CHECK(moved.size() == 1000);
+        CHECK_THROWS((shm::snapshot_view<long, long>(path)), std::runtime_error);
+    }
+    CHECK_THROWS((shm::snapshot_view<int, int>(temp_path("shm_test_missing.snap"))), std::system_error);
+    std::filesystem::remove(path);
+}
+
+SHM_TEST("snapshot/unfinished_writer_publishes_nothing") {
+    const std::string path = temp_path("shm_test_unfinished.snap");
+    CHECK_THROWS(([&] {
+                     shm::snapshot_writer<int, int> out(path, 100);
+                     for (int i = 0; i != 50; ++i) out.insert(i, i);
+                     throw std::runtime_error("source failed");
+                 }()),
+                 std::runtime_error);
+    CHECK(!std::filesystem::exists(path));
+    CHECK_THROWS((shm::snapshot_view<int, int>(path)), std::system_error);
+}
+
+SHM_TEST("snapshot/corrupt_control_bytes") {
+    const std::string path = temp_path("shm_test_corrupt.snap");
+    {
+        shm::snapshot_writer<int, int> out(path, 100);
+        for (int i = 0; i != 100; ++i) out.insert(i, i);
+        out.finish();
+    }
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    shm::detail::snapshot_header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    const auto write = [&](const std::string& image) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(image.data(), static_cast<long>(image.size()));
+    };
+
+    // Every slot full: a miss would never meet an empty slot.
+    std::string full = bytes;
+    std::memset(full.data() + header.ctrl_offset, 0x11, header.capacity);
+    write(full);
+    CHECK_THROWS((shm::snapshot_view<int, int>(path)), std::runtime_error);
+
+    // A tombstone, which no writer leaves behind.
+    std::string deleted = bytes;
+    for (std::uint64_t i = 0; i != header.capacity; ++i) {
+        char& c = deleted[header.ctrl_offset + i];
+        if (static_cast<shm::detail::ctrl_t>(c) >= 0) {
+            c = static_cast<char>(shm::detail::ctrl_deleted);
+            break;
+        }
+    }
+    write(deleted);
+    CHECK_THROWS((shm::snapshot_view<int, int>(path)), std::runtime_error);
+
+    write(bytes);
+    shm::snapshot_view<int, int> view(path);
+    CHECK(view.size() == 100 && view.at(42) == 42 && !view.contains(1000));
+    std::filesystem::remove(path);
+}
+
+#endif  // SHM_SNAPSHOT_HAS_MMAP